@@ -1,7 +1,7 @@
 /*
  * Example: 01_TestWiring
  *
- * Runs a blocking diagnostic test to verify correct wiring of the 7-segment display.
+ * Runs a diagnostic test to verify correct wiring of the 7-segment display.
  *
  * This sketch illuminates segments sequentially (a-g, then dp) on all four digits
  * simultaneously. Use this to:
@@ -14,6 +14,7 @@
  * - Segment 'a' lights for 1 second across all 4 digits
  * - Segment 'b' lights for 1 second across all 4 digits
  * - ... and so on for c, d, e, f, g, dp
+ * - Then each digit lights "8." on its own for 1 second
  * - Serial monitor prints progress
  *
  * **Troubleshooting:**
@@ -58,9 +59,14 @@ void setup() {
   Serial.println("Starting wiring diagnostic...");
   Serial.println("Each segment will light for 1 second.\n");
 
-  // Run the blocking wiring test
-  // This illuminates each segment sequentially (a-g, then dp)
-  display.testWiring(1000); // 1000 ms = 1 second per segment
+  // The ISR walks the test (segments a-g, dp, then each digit); setup()
+  // could go on initializing meanwhile. testWiring(1000) is the blocking
+  // version
+  display.startWiringTest(1000); // 1000 ms = 1 second per step
+  while (display.isTestingWiring()) {
+    Serial.print('.');
+    delay(1000);
+  }
 
   Serial.println("\n Wiring test complete!");
   Serial.println("\nInterpret results:");
@@ -96,9 +96,8 @@ void loop() {
   }
 
   // ========== ISR-BASED DISPLAY REFRESH ==========
-  // The display multiplexing is handled by Timer1 ISR automatically.
-  // This call manages blink state (if enabled).
-//   display.refresh();
+  // Multiplexing and blinking are handled by the Timer1 ISR automatically;
+  // there is nothing to call here.
 
   // ========== OPTIONAL: SERIAL LOGGING ==========
   // Print counter value every 500 ms (non-blocking)
@@ -5,6 +5,8 @@
  * - Text display with character support
  * - Decimal point positioning
  * - Blinking mode
+ * - Scrolling marquee (zero-copy, ISR-driven)
+ * - PROGMEM animation played from the ISR
  * - Error handling
  * - Integer hundredths API (avoids float math)
  *
@@ -27,6 +29,24 @@ const uint8_t segmentPins[] PROGMEM = {2, 3, 4, 5, 6, 7, 8, 9};
 // const uint8_t BTN_MODE = A0;
 // const uint8_t BTN_BLINK = A1;
 
+// ========== ANIMATIONS ==========
+// Segment a running around the outer edge of the display
+const uint8_t SPINNER[][SevenSegment::NUM_DIGITS] PROGMEM = {
+    {0b10000000, 0, 0, 0},
+    {0, 0b10000000, 0, 0},
+    {0, 0, 0b10000000, 0},
+    {0, 0, 0, 0b10000000},
+    {0, 0, 0, 0b01000000},
+    {0, 0, 0, 0b00100000},
+    {0, 0, 0, 0b00010000},
+    {0, 0, 0b00010000, 0},
+    {0, 0b00010000, 0, 0},
+    {0b00010000, 0, 0, 0},
+    {0b00001000, 0, 0, 0},
+    {0b00000100, 0, 0, 0},
+};
+const uint8_t SPINNER_FRAMES = sizeof(SPINNER) / sizeof(SPINNER[0]);
+
 // ========== DISPLAY INSTANCE ==========
 SevenSegment display(segmentPins, digitPins);
 
@@ -106,8 +126,7 @@ void loop()
         break;
     }
 
-    // Display refresh (handles blink state)
-    display.refresh();
+    // No display.refresh() needed: blinking is timed in the ISR
 
     // Optional: check buttons to switch modes
     // if (digitalRead(BTN_MODE) == LOW) {
@@ -163,6 +182,18 @@ void runDemoMode(unsigned long now)
             break;
 
         case 7:
+            Serial.println("Demo Step 8: Scroll a long message from the ISR");
+            display.scrollText(F("SSFD SCROLLING TEXT"), 200);
+            break;
+
+        case 8:
+            Serial.println("Demo Step 9: Spinner animation, then 'DONE'");
+            display.stopScroll();
+            display.playAnimation(SPINNER, SPINNER_FRAMES, 12, 3);
+            display.setText("DONE"); // Staged: shown when the spinner ends
+            break;
+
+        case 9:
             Serial.println("Demo complete! Looping...\n");
             step = 255; // Will wrap to 0
             break;
@@ -219,8 +250,8 @@ void runFixedPointMode(unsigned long now)
         if (hundredths > 9999)
             hundredths = 0;
 
-        // Use integer API (no float math needed!)
-        display.setHundredths(hundredths, 2);
+        // Use integer API (no float math needed!); point after digit 1 = "XX.XX"
+        display.setHundredths(hundredths, 1);
     }
 }
 
@@ -0,0 +1,266 @@
+/*
+ * Example: 04_Benchmark
+ *
+ * Measures SSFD hot paths in CPU cycles on ATmega328P.
+ *
+ * Timer1 runs free at prescaler 1 as a cycle counter, so the display is
+ * started on Timer2 instead. Each case runs with interrupts masked and the
+ * best of several runs is reported, minus the cost of an empty measurement.
+ *
+ * ISR CPU load is measured separately, with interrupts enabled: a spin
+ * loop counts iterations for a fixed window with the display stopped and
+ * again while it multiplexes at each refresh rate. The lost iterations are
+ * the share of the CPU taken by the display ISR (vector entry/exit included).
+ *
+ * **Output (machine-readable, one line per record):**
+ * ```
+ * BENCH,<case>,<cycles>
+ * LOAD,<refresh_hz>,<cycles_per_tick>,<load_percent_x100>
+ * STATS,<min>,<mean>,<max>,<jitter>,<missed>   (only with SSFD_STATS=1)
+ * ```
+ *
+ * **Cases:**
+ * - div_loop      Reference: old `% 10` / `/ 10` digit extraction
+ * - split_decimal Reference: reciprocal-multiply extraction used by setNumber()
+ * - setNumber     Full setNumber() including pattern lookup and publish
+ * - setFloat      setFloat(12.34f)          (SSFD_FLOAT builds)
+ * - setFixed      setFixed(1234, -2)
+ * - setInt        setInt(-123)
+ * - setHex        setHex(0xBEEF)
+ * - setText       setText("HELP")           (SSFD_TEXT builds)
+ * - setSegments   setSegments() with a 4-byte RAM pattern
+ * - clear         clear() of a lit frame
+ * - setNumber_repeat  setNumber() with the previous value (change detection)
+ * - multiplex     One multiplex() tick (main context, no ISR prologue)
+ *
+ * Each setter case except setNumber_repeat alternates between two inputs so
+ * that change detection does not turn the best-of runs into repeat calls.
+ */
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include "SSFD.h"
+
+// ========== PIN CONFIGURATION ==========
+const uint8_t digitPins[] PROGMEM = {10, 11, 12, 13};
+const uint8_t segmentPins[] PROGMEM = {2, 3, 4, 5, 6, 7, 8, 9};
+
+// ========== DISPLAY INSTANCE ==========
+SevenSegment display(segmentPins, digitPins);
+
+// ========== BENCHMARK SETTINGS ==========
+const uint8_t RUNS = 16;           // Best-of runs per case
+volatile uint8_t sink[4];          // Defeats dead-code elimination
+volatile uint8_t benchFlip;        // Alternates the setter inputs
+volatile uint16_t benchValue = 1234;
+volatile uint16_t benchValues[2] = {1234, 1235};
+volatile float benchFloats[2] = {12.34f, 12.35f};
+volatile int32_t benchMantissas[2] = {1234, 1235};
+volatile int16_t benchInts[2] = {-123, -124};
+volatile uint16_t benchHex[2] = {0xBEEF, 0xBEEE};
+const char *const benchTexts[2] = {"HELP", "HELd"};
+uint8_t benchPatterns[2][4] = {{0x6E, 0x9E, 0x1C, 0xCE}, {0x6E, 0x9E, 0x1C, 0x7A}};
+
+// ISR load measurement
+const uint16_t LOAD_WINDOW_MS = 250;
+const uint16_t LOAD_RATES[] = {60, 125, 250, 500, 1000};
+
+// ========== CYCLE COUNTER ==========
+void startCycleCounter()
+{
+    TCCR1A = 0;
+    TCCR1B = (1 << CS10); // Normal mode, no prescale: 1 count = 1 cycle
+}
+
+// Measure fn() in cycles (best of RUNS, overhead removed); prepare() runs
+// untimed before each run
+uint16_t measure(void (*fn)(), uint16_t overhead, void (*prepare)() = nullptr)
+{
+    uint16_t best = 0xFFFF;
+    for (uint8_t r = 0; r < RUNS; r++)
+    {
+        if (prepare != nullptr)
+        {
+            prepare();
+        }
+        uint16_t elapsed;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            uint16_t start = TCNT1;
+            fn();
+            elapsed = TCNT1 - start;
+        }
+        if (elapsed < best)
+            best = elapsed;
+    }
+    return best > overhead ? best - overhead : 0;
+}
+
+void report(const char *name, uint16_t cycles)
+{
+    Serial.print(F("BENCH,"));
+    Serial.print(name);
+    Serial.print(',');
+    Serial.println(cycles);
+}
+
+// ========== CASES ==========
+void benchEmpty() {}
+
+void benchDivLoop()
+{
+    uint16_t temp = benchValue;
+    for (int8_t i = 3; i >= 0; i--)
+    {
+        sink[i] = temp % 10;
+        temp /= 10;
+    }
+}
+
+void benchSplitDecimal()
+{
+    uint16_t value = benchValue;
+    uint8_t hi = (uint8_t)(((uint32_t)value * 5243) >> 19);
+    uint8_t lo = (uint8_t)(value - hi * 100);
+    uint8_t tens = (uint8_t)(((uint16_t)hi * 205) >> 11);
+    sink[0] = tens;
+    sink[1] = hi - tens * 10;
+    tens = (uint8_t)(((uint16_t)lo * 205) >> 11);
+    sink[2] = tens;
+    sink[3] = lo - tens * 10;
+}
+
+void benchSetNumber() { display.setNumber(benchValues[benchFlip ^= 1]); }
+
+#if SSFD_FLOAT
+void benchSetFloat() { display.setFloat(benchFloats[benchFlip ^= 1]); }
+#endif
+
+void benchSetFixed() { display.setFixed(benchMantissas[benchFlip ^= 1], -2); }
+
+void benchSetInt() { display.setInt(benchInts[benchFlip ^= 1]); }
+
+void benchSetHex() { display.setHex(benchHex[benchFlip ^= 1]); }
+
+#if SSFD_TEXT
+void benchSetText() { display.setText(benchTexts[benchFlip ^= 1]); }
+#endif
+
+void benchSetSegments() { display.setSegments(benchPatterns[benchFlip ^= 1]); }
+
+void benchClear() { display.clear(); }
+
+// Re-light the frame before each clear() run so it has work to do
+void prepareClear() { display.setSegments(benchPatterns[0]); }
+
+void benchSetNumberRepeat() { display.setNumber(benchValue); }
+
+void benchMultiplex() { display.multiplex(); }
+
+// ========== ISR LOAD ==========
+// Spin-loop iterations completed in LOAD_WINDOW_MS (interrupts enabled)
+uint32_t spin()
+{
+    uint32_t iterations = 0;
+    unsigned long start = millis();
+    while (millis() - start < LOAD_WINDOW_MS)
+    {
+        iterations++;
+    }
+    return iterations;
+}
+
+void reportLoad(uint16_t hz, uint32_t idle)
+{
+    display.setRefreshRate(hz);
+    display.begin(ssfdTimer2);
+    display.setNumber(8888); // All segments lit: worst-case drive
+    uint32_t busy = spin();
+
+    // Share of iterations lost to the ISR, in hundredths of a percent
+    uint32_t lost = idle > busy ? idle - busy : 0;
+    uint32_t loadX100 = (lost * 10000UL + idle / 2) / idle;
+    uint32_t cyclesPerTick = (F_CPU / 10000UL) * loadX100 /
+                             ((uint32_t)hz * SevenSegment::NUM_DIGITS);
+
+    Serial.print(F("LOAD,"));
+    Serial.print(hz);
+    Serial.print(',');
+    Serial.print(cyclesPerTick);
+    Serial.print(',');
+    Serial.println(loadX100);
+}
+
+// ========== SETUP ==========
+void setup()
+{
+    Serial.begin(115200);
+    delay(500);
+
+    // Keep Timer1 free for cycle counting
+    if (display.begin(ssfdTimer2) != SevenSegment::Error::OK)
+    {
+        Serial.println(F("BENCH,error,init"));
+        while (1)
+            ;
+    }
+
+    startCycleCounter();
+    uint16_t overhead = measure(benchEmpty, 0);
+
+    Serial.println(F("BENCH,begin,ATmega328P"));
+    Serial.print(F("BENCH,f_cpu,"));
+    Serial.println(F_CPU);
+
+    report("div_loop", measure(benchDivLoop, overhead));
+    report("split_decimal", measure(benchSplitDecimal, overhead));
+    report("setNumber", measure(benchSetNumber, overhead));
+#if SSFD_FLOAT
+    report("setFloat", measure(benchSetFloat, overhead));
+#endif
+    report("setFixed", measure(benchSetFixed, overhead));
+    report("setInt", measure(benchSetInt, overhead));
+    report("setHex", measure(benchSetHex, overhead));
+#if SSFD_TEXT
+    report("setText", measure(benchSetText, overhead));
+#endif
+    report("setSegments", measure(benchSetSegments, overhead));
+    report("clear", measure(benchClear, overhead, prepareClear));
+    report("setNumber_repeat", measure(benchSetNumberRepeat, overhead));
+    report("multiplex", measure(benchMultiplex, overhead));
+
+    // Baseline with the display stopped, then each refresh rate
+    Serial.flush(); // Keep UART interrupts out of the load windows
+    display.end();
+    uint32_t idle = spin();
+    for (uint8_t i = 0; i < sizeof(LOAD_RATES) / sizeof(LOAD_RATES[0]); i++)
+    {
+        reportLoad(LOAD_RATES[i], idle);
+        Serial.flush();
+    }
+    display.setRefreshRate(SevenSegment::DEFAULT_REFRESH_HZ);
+
+#if SSFD_STATS
+    // Timer2 stats, quantized to its prescaler (see README)
+    SevenSegment::Stats st = display.getStats();
+    Serial.print(F("STATS,"));
+    Serial.print(st.minCycles);
+    Serial.print(',');
+    Serial.print(st.meanCycles);
+    Serial.print(',');
+    Serial.print(st.maxCycles);
+    Serial.print(',');
+    Serial.print(st.jitter);
+    Serial.print(',');
+    Serial.println(st.missedTicks);
+#endif
+
+    Serial.println(F("BENCH,end,0"));
+}
+
+// ========== LOOP ==========
+void loop()
+{
+    // Benchmarks run once in setup()
+}
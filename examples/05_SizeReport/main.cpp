@@ -0,0 +1,146 @@
+/*
+ * Example: 05_SizeReport
+ *
+ * Reports the flash and RAM this build uses on ATmega328P, for comparing
+ * the SSFD feature switches (see SSFD_Config.h).
+ *
+ * The sketch calls every enabled subsystem once, so each one is linked as
+ * a real sketch would link it. Build it once per profile with the same
+ * flags for the library and the sketch (PlatformIO `build_flags`, or
+ * arduino-cli `--build-property compiler.cpp.extra_flags=...`):
+ *
+ * ```
+ * -DSIZE_REPORT_BASELINE=1                   core + Serial only, no display
+ * -DSSFD_PROFILE_MINIMAL=1                   setNumber / setInt / setHex / print
+ * -DSSFD_PROFILE_MINIMAL=1 -DSSFD_FLOAT=1    minimal + one subsystem ...
+ * (no flags)                                 every subsystem (default build)
+ * -DSSFD_STATS=1                             default + instrumentation
+ * ```
+ *
+ * A subsystem's cost is its build minus the minimal build; the minimal
+ * build minus the baseline is the core display driver. Flash matches the
+ * "Sketch uses" line of the IDE; static RAM matches "Global variables".
+ *
+ * **Output (machine-readable, one line per record):**
+ * ```
+ * SIZE,features,<float><text><blink><marquee><animation><counter><stats>   (1 = built in)
+ * SIZE,flash,<bytes>           .text + .data image in flash
+ * SIZE,static_ram,<bytes>      .data + .bss
+ * SIZE,display_object,<bytes>  sizeof(SevenSegment), part of static_ram
+ * SIZE,free_ram,<bytes>        between the heap end and the stack
+ * ```
+ */
+
+#include <Arduino.h>
+#include "SSFD.h"
+
+// avr-libc linker script symbols
+extern "C" {
+extern char __data_start;
+extern char __data_load_end;
+extern char __bss_end;
+extern char* __brkval;
+}
+
+// ========== PIN CONFIGURATION ==========
+const uint8_t digitPins[] PROGMEM = {10, 11, 12, 13};
+const uint8_t segmentPins[] PROGMEM = {2, 3, 4, 5, 6, 7, 8, 9};
+
+#if !SIZE_REPORT_BASELINE
+// ========== DISPLAY INSTANCE ==========
+SevenSegment display(segmentPins, digitPins);
+
+#if SSFD_ANIMATION
+const uint8_t FRAMES[][SevenSegment::NUM_DIGITS] PROGMEM = {
+    {0b10000000, 0b10000000, 0b10000000, 0b10000000},
+    {0b00000010, 0b00000010, 0b00000010, 0b00000010},
+};
+#endif
+
+// Reads the inputs at run time, so no call is folded away
+volatile uint16_t input = 42;
+
+/**
+ * One call into each enabled subsystem
+ */
+void exerciseDisplay()
+{
+    display.setNumber(input);
+    display.setInt((int16_t)input);
+    display.setHex(input);
+    display.print(input);
+    display.println();
+#if SSFD_FLOAT
+    display.setFloat(input / 10.0f);
+#endif
+#if SSFD_TEXT
+    display.setText(input ? "On" : "OFF");
+#endif
+#if SSFD_BLINK
+    display.startBlink(input);
+    display.stopBlink();
+#endif
+#if SSFD_MARQUEE
+    display.scrollText(F("SIZE REPORT"), input);
+    display.stopScroll();
+#endif
+#if SSFD_ANIMATION
+    display.playAnimation(FRAMES, 2, (uint8_t)input);
+    display.stopAnimation();
+#endif
+#if SSFD_COUNTER
+    display.startCounter(input, 1000);
+    display.stopCounter();
+#endif
+#if SSFD_STATS
+    display.getStats();
+#endif
+}
+#endif
+
+void report(const __FlashStringHelper *name, unsigned long value)
+{
+    Serial.print(F("SIZE,"));
+    Serial.print(name);
+    Serial.print(',');
+    Serial.println(value);
+}
+
+// ========== SETUP ==========
+void setup()
+{
+    Serial.begin(115200);
+
+#if !SIZE_REPORT_BASELINE
+    display.begin();
+    exerciseDisplay();
+#endif
+
+    Serial.print(F("SIZE,features,"));
+#if SIZE_REPORT_BASELINE
+    Serial.println(F("baseline"));
+#else
+    Serial.print(SSFD_FLOAT);
+    Serial.print(SSFD_TEXT);
+    Serial.print(SSFD_BLINK);
+    Serial.print(SSFD_MARQUEE);
+    Serial.print(SSFD_ANIMATION);
+    Serial.print(SSFD_COUNTER);
+    Serial.println(SSFD_STATS);
+#endif
+
+    uint8_t stackTop;
+    char *heapEnd = __brkval != nullptr ? __brkval : &__bss_end;
+    report(F("flash"), (uintptr_t)&__data_load_end);
+    report(F("static_ram"), (uintptr_t)&__bss_end - (uintptr_t)&__data_start);
+#if !SIZE_REPORT_BASELINE
+    report(F("display_object"), sizeof(display));
+#endif
+    report(F("free_ram"), (uintptr_t)&stackTop - (uintptr_t)heapEnd);
+}
+
+// ========== LOOP ==========
+void loop()
+{
+    // The report is printed once in setup()
+}
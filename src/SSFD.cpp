@@ -4,13 +4,12 @@
  */
 
 #include "SSFD.h"
-#include <avr/pgmspace.h>
 #include <string.h>
-#include <math.h>
 
-// ========== PROGMEM LOOKUP TABLE ==========
+// ========== PROGMEM FONT ==========
+#if SSFD_TEXT
 /**
- * 7-segment mappings for digits and symbols
+ * 7-segment font indexed directly by character code
  * Bit layout: 7=a, 6=b, 5=c, 4=d, 3=e, 2=f, 1=g, 0=dp
  *
  *     a
@@ -18,519 +17,2827 @@
  *     g
  *  e     c
  *     d    dp
+ *
+ * Lowercase letters use their own glyphs where a 7-segment form exists
+ * (b, c, d, h, o, u ...). Characters without a glyph are blank. Weak, so
+ * a sketch can replace the whole table by defining its own ssfdFont.
  */
-const uint8_t SEGMENT_PATTERNS[] PROGMEM = {
-
-    // Digits 0-9
-    0b11111100, // 0: a,b,c,d,e,f
-    0b01100000, // 1: b,c
-    0b11011010, // 2: a,b,d,e,g
-    0b11110010, // 3: a,b,c,d,g
-    0b01100110, // 4: b,c,f,g
-    0b10110110, // 5: a,c,d,f,g
-    0b10111110, // 6: a,c,d,e,f,g
-    0b11100000, // 7: a,b,c
-    0b11111110, // 8: all except dp
-    0b11110110, // 9: a,b,c,d,f,g
-    0b00000000, // 10: BLANK
-    0b00000001, // 11: dp only
-
-    // Extended characters
-    0b11101110, // 12: A (a,b,c,e,f,g)
-    0b00111110, // 13: b (c,d,e,f,g)
-    0b10011100, // 14: C (a,d,e,f) — uppercase C
-    0b01111010, // 15: d (b,c,d,e,g)
-    0b10011110, // 16: E (a,d,e,f,g)
-    0b10001110, // 17: F (a,e,f,g)
-    0b10111100, // 18: G (a,c,d,e,f)
-    0b01101110, // 19: H (b,c,e,f,g)
-    0b01100000, // 20: I (b,c)
-    0b01111000, // 21: J (b,c,d,e)
-    0b00001110, // 22: K (e,f,g) — approximation
-    0b00011100, // 23: L (d,e,f)
-    0b10101000, // 24: M (a,c,e) — approximation
-    0b00101010, // 25: n (c,e,g)
-    0b11111100, // 26: O (a,b,c,d,e,f)
-    0b11001110, // 27: P (a,b,e,f,g)
-    0b11110110, // 28: Q (a,b,c,d,f,g)
-    0b00001010, // 29: r (e,g)
-    0b10110110, // 30: S (a,c,d,f,g)
-    0b00011110, // 31: T (d,e,f,g)
-    0b01111100, // 32: U (b,c,d,e,f)
-    0b01110000, // 33: V (b,c,d,e) — approximation
-    0b01010100, // 34: W (b,c,d,f) — approximation
-    0b01001110, // 35: X (b,c,e,f,g) — approximation
-    0b01110110, // 36: Y (b,c,d,f,g)
-    0b11011010, // 37: Z (a,b,d,e,g)
-
-    // Extended symbols
-    0b00000000, // 38: SPACE
-    0b00000010, // 39: dash/minus (g)
-    0b11000000, // 40: equals (b,c,d,e) — approximation
+// extern keeps the const table public so the weak symbol can be replaced
+extern const uint8_t ssfdFont[SSFD_FONT_SIZE] PROGMEM __attribute__((weak)) = {
+    // 0x00-0x1F: control codes (blank)
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0b00000000, // 0x20 space: blank
+    0b01100001, // 0x21 !: b,c,dp
+    0b01000100, // 0x22 double quote: b,f
+    0b00000000, // 0x23 # (no glyph)
+    0b10110110, // 0x24 $: a,c,d,f,g
+    0b00000000, // 0x25 % (no glyph)
+    0b00000000, // 0x26 & (no glyph)
+    0b01000000, // 0x27 apostrophe: b
+    0b10011100, // 0x28 (: a,d,e,f
+    0b11110000, // 0x29 ): a,b,c,d
+    0b11000110, // 0x2A *: a,b,f,g
+    0b00000000, // 0x2B + (no glyph)
+    0b00000001, // 0x2C ,: dp
+    0b00000010, // 0x2D -: g
+    0b00000001, // 0x2E .: dp
+    0b01001010, // 0x2F /: b,e,g
+    0b11111100, // 0x30 0: a,b,c,d,e,f
+    0b01100000, // 0x31 1: b,c
+    0b11011010, // 0x32 2: a,b,d,e,g
+    0b11110010, // 0x33 3: a,b,c,d,g
+    0b01100110, // 0x34 4: b,c,f,g
+    0b10110110, // 0x35 5: a,c,d,f,g
+    0b10111110, // 0x36 6: a,c,d,e,f,g
+    0b11100000, // 0x37 7: a,b,c
+    0b11111110, // 0x38 8: a,b,c,d,e,f,g
+    0b11110110, // 0x39 9: a,b,c,d,f,g
+    0b00000000, // 0x3A : (no glyph)
+    0b00000000, // 0x3B ; (no glyph)
+    0b00000000, // 0x3C < (no glyph)
+    0b00010010, // 0x3D =: d,g
+    0b00000000, // 0x3E > (no glyph)
+    0b11001010, // 0x3F ?: a,b,e,g
+    0b00000000, // 0x40 @ (no glyph)
+    0b11101110, // 0x41 A: a,b,c,e,f,g
+    0b00111110, // 0x42 B: c,d,e,f,g
+    0b10011100, // 0x43 C: a,d,e,f
+    0b01111010, // 0x44 D: b,c,d,e,g
+    0b10011110, // 0x45 E: a,d,e,f,g
+    0b10001110, // 0x46 F: a,e,f,g
+    0b10111100, // 0x47 G: a,c,d,e,f
+    0b01101110, // 0x48 H: b,c,e,f,g
+    0b01100000, // 0x49 I: b,c
+    0b01111000, // 0x4A J: b,c,d,e
+    0b00001110, // 0x4B K: e,f,g — approximation
+    0b00011100, // 0x4C L: d,e,f
+    0b10101000, // 0x4D M: a,c,e — approximation
+    0b00101010, // 0x4E N: c,e,g
+    0b11111100, // 0x4F O: a,b,c,d,e,f
+    0b11001110, // 0x50 P: a,b,e,f,g
+    0b11110110, // 0x51 Q: a,b,c,d,f,g
+    0b00001010, // 0x52 R: e,g
+    0b10110110, // 0x53 S: a,c,d,f,g
+    0b00011110, // 0x54 T: d,e,f,g
+    0b01111100, // 0x55 U: b,c,d,e,f
+    0b01110000, // 0x56 V: b,c,d — approximation
+    0b01010100, // 0x57 W: b,d,f — approximation
+    0b01001110, // 0x58 X: b,e,f,g — approximation
+    0b01110110, // 0x59 Y: b,c,d,f,g
+    0b11011010, // 0x5A Z: a,b,d,e,g
+    0b10011100, // 0x5B [: a,d,e,f
+    0b00100110, // 0x5C backslash: c,f,g
+    0b11110000, // 0x5D ]: a,b,c,d
+    0b11000100, // 0x5E ^: a,b,f
+    0b00010000, // 0x5F _: d
+    0b00000100, // 0x60 `: f
+    0b11111010, // 0x61 a: a,b,c,d,e,g
+    0b00111110, // 0x62 b: c,d,e,f,g
+    0b00011010, // 0x63 c: d,e,g
+    0b01111010, // 0x64 d: b,c,d,e,g
+    0b11011110, // 0x65 e: a,b,d,e,f,g
+    0b10001110, // 0x66 f: a,e,f,g
+    0b11110110, // 0x67 g: a,b,c,d,f,g
+    0b00101110, // 0x68 h: c,e,f,g
+    0b00100000, // 0x69 i: c
+    0b01110000, // 0x6A j: b,c,d
+    0b00001110, // 0x6B k: e,f,g — approximation
+    0b00001100, // 0x6C l: e,f
+    0b10101000, // 0x6D m: a,c,e — approximation
+    0b00101010, // 0x6E n: c,e,g
+    0b00111010, // 0x6F o: c,d,e,g
+    0b11001110, // 0x70 p: a,b,e,f,g
+    0b11100110, // 0x71 q: a,b,c,f,g
+    0b00001010, // 0x72 r: e,g
+    0b10110110, // 0x73 s: a,c,d,f,g
+    0b00011110, // 0x74 t: d,e,f,g
+    0b00111000, // 0x75 u: c,d,e
+    0b00111000, // 0x76 v: c,d,e — approximation
+    0b01010100, // 0x77 w: b,d,f — approximation
+    0b01001110, // 0x78 x: b,e,f,g — approximation
+    0b01110110, // 0x79 y: b,c,d,f,g
+    0b11011010, // 0x7A z: a,b,d,e,g
+    0b10011100, // 0x7B {: a,d,e,f
+    0b00001100, // 0x7C |: e,f
+    0b11110000, // 0x7D }: a,b,c,d
+    0b10000000, // 0x7E ~: a
+    0b11000110, // 0x7F DEL (degree): a,b,f,g
+
+#if SSFD_FONT_SIZE > 128
+    // 0x80-0xFF: Latin-1; only 0xB0 (degree) has a glyph
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0b11000110, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+#endif
 };
-
-// Static instance pointer for ISR
-static SevenSegment *_isrInstance = nullptr;
-
-// ========== ISR HANDLER ==========
+#else
 /**
- * Timer1 Compare Match ISR
+ * Without SSFD_TEXT: the numerals 0-9 and A-F only (same glyphs as the
+ * full font), indexed by value
  */
-ISR(TIMER1_COMPA_vect)
+static const uint8_t HEX_FONT[16] PROGMEM = {
+    0b11111100, 0b01100000, 0b11011010, 0b11110010, // 0 1 2 3
+    0b01100110, 0b10110110, 0b10111110, 0b11100000, // 4 5 6 7
+    0b11111110, 0b11110110, 0b11101110, 0b00111110, // 8 9 A b
+    0b10011100, 0b01111010, 0b10011110, 0b10001110, // C d E F
+};
+
+static const uint8_t PATTERN_MINUS = 0b00000010;
+#endif
+
+// Patterns composed outside the font
+static const uint8_t PATTERN_BLANK = 0b00000000;
+static const uint8_t PATTERN_DP = 0b00000001;
+
+// Keeps frame stores on the correct side of the publish flag
+static inline void compilerBarrier()
 {
-    if (_isrInstance != nullptr && _isrInstance->_isrActive)
-    {
-        _isrInstance->multiplex();
-    }
+    __asm__ __volatile__("" ::: "memory");
 }
 
+SSFDExternalTick ssfdExternalTick;
+
 // ========== CONSTRUCTOR ==========
-SevenSegment::SevenSegment(const uint8_t *segmentPins, const uint8_t *digitPins)
+SevenSegmentBase::SevenSegmentBase(uint8_t digitCount)
     : _isrActive(false),
-      _segmentPins(segmentPins),
-      _digitPins(digitPins),
+      _selfRefreshing(false),
+      _deferredOutput(false),
+      _numDigits(digitCount >= 1 && digitCount <= MAX_DIGITS ? digitCount : 0),
+      _frontFrame(0),
+      _framePending(false),
+      _frameOpen(false),
+      _cursor(0),
+      _lineEnded(true),
       _leadingZeros(true),
-      _currentDigit(0),
-      _refreshIntervalMs(3),
-      _lastRefreshTime(0),
+      _scanMode(ScanMode::FULL),
+      _scanOrder(ScanOrder::DIGITS),
+      _scanDirty(true),
+      _scanSlots(_numDigits),
+      _scanPeriod(_numDigits),
+      _scanSlot(0),
+      _frameTicks(0),
+      _scanStretched(false),
+      _scanDarkDriven(false),
+      _scanLit(0),
+      _refreshHz(DEFAULT_REFRESH_HZ),
+      _timer(nullptr),
+      _nextClient(nullptr),
+#if SSFD_BLINK
       _blinkEnabled(false),
-      _blinkStateOn(true),
+      _blinkMask(ALL_DIGITS),
+      _blinkHidden(0),
+      _blinkFrames(1),
+      _blinkCountdown(1),
       _blinkInterval(500),
-      _blinkLastToggle(0),
+#endif
+      _overlayMode(OVERLAY_NONE),
+#if SSFD_MARQUEE
+      _scrollText(nullptr),
+      _scrollProgmem(false),
+      _scrollMode(ScrollMode::WRAP),
+      _scrollLength(0),
+      _scrollPos(0),
+      _scrollStep(1),
+      _scrollFrames(1),
+      _scrollCountdown(1),
+      _scrollInterval(300),
+      _scrollDone(nullptr),
+#endif
+      _testStep(0),
+      _testFrames(1),
+      _testCountdown(1),
+      _testInterval(0),
+      _testResume(OVERLAY_NONE),
+      _testDone(nullptr),
+#if SSFD_ANIMATION
+      _animQueued(false),
+      _animIndex(0),
+      _animLoopsLeft(0),
+      _animCountdown(1),
+#endif
+#if SSFD_COUNTER
+      _counterDown(false),
+      _counterStepTop(0),
+      _counterSixes(0xFF),
+      _counterColon(0xFF),
+      _counterPaused(false),
+      _counterInterval(0),
+      _counterPeriod(1),
+      _counterElapsed(0),
+#endif
+      _blankStop(false),
+      _timerGated(false),
+      _idling(false),
+      _idleAfter(0),
+      _idleHz(MIN_REFRESH_HZ),
+      _idleCountdown(0),
+      _brightness(MAX_BRIGHTNESS),
+      _fadeTarget(MAX_BRIGHTNESS),
+      _fadeLevel(0),
+      _fadeStep(0),
+      _fadeFrames(0),
+      _digitDimmed(false),
       _lastError(Error::OK)
 {
-    memset((void *)_displayPatterns, 0, NUM_DIGITS);
-    _isrInstance = this;
+    memset(_frames, 0, sizeof(_frames));
+    memset(_digitLevel, MAX_DIGIT_LEVEL, sizeof(_digitLevel));
+    memset(_digitDuty, MAX_BRIGHTNESS, sizeof(_digitDuty));
+    memset(_overlay, 0, sizeof(_overlay));
+    memset(_segmentDigits, 0, sizeof(_segmentDigits));
+    for (uint8_t i = 0; i < NUM_SEGMENTS; i++)
+    {
+        _scanList[i] = i;
+    }
+    _scanSource = _frames[0];
+#if SSFD_ANIMATION
+    memset(&_anim, 0, sizeof(_anim));
+    memset(&_animNext, 0, sizeof(_animNext));
+#endif
+#if SSFD_COUNTER
+    memset(_counterDigits, 0, sizeof(_counterDigits));
+    memset(_counterStep, 0, sizeof(_counterStep));
+#endif
+    rememberCall(SET_NONE, 0, 0);
+#if SSFD_STATS
+    _statsResolution = 1;
+    resetStats();
+#endif
 }
 
-// ========== VALIDATION HELPERS ==========
-bool SevenSegment::isPinValid(uint8_t pin)
+// ========== DESTRUCTOR ==========
+SevenSegmentBase::~SevenSegmentBase()
 {
-    return pin <= MAX_PIN;
+    // The timer must not keep a pointer to a display that no longer exists
+    if (_timer != nullptr)
+    {
+        releaseTimer();
+    }
 }
 
 // ========== begin() ==========
-SevenSegment::Error SevenSegment::begin()
+SevenSegmentBase::Error SevenSegmentBase::begin(SSFDTimer &timer, ScanOrder order)
 {
-    // Validate pointers
-    if (_segmentPins == nullptr || _digitPins == nullptr)
+    if (_numDigits == 0)
+    {
+        return _lastError = Error::INVALID_ARGUMENT;
+    }
+
+    // A self-refreshing output scans digit by digit itself
+    if (order == ScanOrder::SEGMENTS && _selfRefreshing)
+    {
+        return _lastError = Error::NOT_SUPPORTED;
+    }
+
+    // Validate and configure the output pins
+    _lastError = beginOutput();
+    if (_lastError != Error::OK)
     {
-        _lastError = Error::NULL_POINTER;
         return _lastError;
     }
 
-    // Validate all pins before initializing
-    for (uint8_t i = 0; i < NUM_SEGMENTS; i++)
+    // Release a previous backend before taking the new one
+    if (_timer != nullptr)
     {
-        uint8_t pin = pgm_read_byte(&_segmentPins[i]);
-        if (!isPinValid(pin))
-        {
-            _lastError = Error::INVALID_PIN;
-            return _lastError;
-        }
+        releaseTimer();
     }
 
-    for (uint8_t i = 0; i < NUM_DIGITS; i++)
+    // Outputs with their own refresh need no timer; show the frame now
+    if (_selfRefreshing)
     {
-        uint8_t pin = pgm_read_byte(&_digitPins[i]);
-        if (!isPinValid(pin))
+        _isrActive = true;
+        frameUpdated(_frames[_frontFrame], nullptr);
+        _lastError = Error::OK;
+        return _lastError;
+    }
+
+    // Off every timer now: a new order restarts the scan with a new list
+    if (order != _scanOrder)
+    {
+        _scanOrder = order;
+        _scanSlots = 0;
+        _scanDirty = true;
+    }
+
+    _timer = &timer;
+    _scanStretched = false; // start() programs the base period
+    _timerGated = false;
+    _idling = false;
+    _idleCountdown = (uint32_t)_idleAfter * _refreshHz;
+    _timer->attach(this);
+
+    // Displays on one timer share its frame rate
+    for (SevenSegmentBase *display = _timer->_clients; display != nullptr;
+         display = display->_nextClient)
+    {
+        if (display != this)
         {
-            _lastError = Error::INVALID_PIN;
-            return _lastError;
+            display->adoptRefreshRate(_refreshHz);
         }
     }
+    _isrActive = true;
 
-    // Initialize segment pins
-    for (uint8_t i = 0; i < NUM_SEGMENTS; i++)
+    // One interrupt per digit or segment line (of the widest display, or of
+    // every display in turn; see SSFDTimer::Schedule)
+    if (!_timer->start((uint32_t)_refreshHz * _timer->ticksPerFrame()))
     {
-        uint8_t pin = pgm_read_byte(&_segmentPins[i]);
-        pinMode(pin, OUTPUT);
-        digitalWrite(pin, LOW);
+        _isrActive = false;
+        releaseTimer();
+        _lastError = Error::TIMER_INIT_FAILED;
+        return _lastError;
     }
 
-    // Initialize digit pins
-    for (uint8_t i = 0; i < NUM_DIGITS; i++)
+    // Shared like the frame rate; a timer that cannot dim stays at full
+    if (!applyBrightness(_brightness))
     {
-        uint8_t pin = pgm_read_byte(&_digitPins[i]);
-        pinMode(pin, OUTPUT);
-        digitalWrite(pin, LOW);
+        _brightness = MAX_BRIGHTNESS;
     }
 
-    // Setup Timer1 for ~80 Hz multiplexing (16MHz / 64 / 3125)
-    cli(); 
-    TCCR1A = 0;
-    TCCR1B = 0;
-    TCNT1 = 0;
-    OCR1A = 499;
-    TCCR1B |= (1 << WGM12) | (1 << CS11) | (1 << CS10); // CTC mode, /64 prescale
-    TIMSK1 |= (1 << OCIE1A);
-    _isrActive = true;
-    sei(); 
-
     _lastError = Error::OK;
     return _lastError;
 }
 
 // ========== end() ==========
-void SevenSegment::end()
+void SevenSegmentBase::end()
 {
-    cli();
+    if (_timer != nullptr)
+    {
+        releaseTimer();
+    }
     _isrActive = false;
-    TIMSK1 &= ~(1 << OCIE1A);
-    sei();
+    _timerGated = false;
+    _idling = false;
+    _idleCountdown = 0;
+    _frameOpen = false;
+    drive(0, 0);
+    flushOutput();
     clear();
 }
 
-// ========== refresh() ==========
-void SevenSegment::refresh()
+// ========== releaseTimer() ==========
+void SevenSegmentBase::releaseTimer()
 {
-    // Non-blocking refresh — allows manual multiplexing if not using ISR
-    // (Currently ISR handles it, but kept for API flexibility)
-    if (_blinkEnabled)
+    SSFDTimer *timer = _timer;
+    timer->detach(this);
+    _timer = nullptr;
+
+    // Stop the timer with its last display; otherwise the frame is shorter now
+    SevenSegmentBase *first = timer->_clients;
+    if (first == nullptr)
     {
-        unsigned long now = millis();
-        if (now - _blinkLastToggle >= _blinkInterval)
-        {
-            _blinkStateOn = !_blinkStateOn;
-            _blinkLastToggle = now;
-        }
+        timer->stop();
+    }
+    else
+    {
+        timer->setRate((uint32_t)first->_refreshHz * timer->ticksPerFrame());
     }
 }
 
-// ========== multiplex() ==========
-void SevenSegment::multiplex()
+// ========== refresh() ==========
+void SevenSegmentBase::refresh()
 {
+    // Multiplexing and blink timing both run in the ISR; nothing to do
+}
 
-    uint8_t prevDigit = _currentDigit;
-    digitalWrite(pgm_read_byte(&_digitPins[prevDigit]), LOW);
-
-    _currentDigit = (_currentDigit + 1) % NUM_DIGITS;
+// ========== multiplex() ==========
+SSFD_ISR_ATTR bool SevenSegmentBase::multiplex()
+{
+    if (!_isrActive || _timerGated)
+    {
+        return true;
+    }
 
-    if (_blinkEnabled && !_blinkStateOn)
+    // Undo the dark-tick stretch of the period that just ended
+    if (_scanStretched)
     {
-        return;
+        _timer->stretchTick(1);
+        _scanStretched = false;
     }
+    _frameTicks++;
+
+    // Pick up a published frame only at a scan boundary (no tearing)
+    if (++_scanSlot >= _scanSlots)
+    {
+        _scanSlot = 0;
+
+        if (_framePending)
+        {
+            _frontFrame ^= 1;
+            _framePending = false;
+            _scanDirty = true;
+        }
+
+        // Frame-timed state advances once per frame of ticks, however
+        // many of them the scan used
+        if (_frameTicks >= _scanPeriod)
+        {
+            _frameTicks -= _scanPeriod;
+
+#if SSFD_BLINK
+            if (_blinkEnabled && --_blinkCountdown == 0)
+            {
+                _blinkCountdown = _blinkFrames;
+                _blinkHidden = _blinkHidden ? 0 : _blinkMask;
+            }
+#endif
+
+            if (_fadeFrames != 0)
+            {
+                stepFade();
+            }
+
+            switch (_overlayMode)
+            {
+#if SSFD_MARQUEE
+            case OVERLAY_SCROLL:
+                stepScroll();
+                break;
+#endif
+#if SSFD_ANIMATION
+            case OVERLAY_ANIMATION:
+                stepAnimation();
+                break;
+#endif
+#if SSFD_COUNTER
+            case OVERLAY_COUNTER:
+                stepCounter();
+                break;
+#endif
+            case OVERLAY_WIRING:
+                stepWiringTest();
+                break;
+            }
+
+            // Idle refresh: count static frames, then slow the timer once
+            // (only a timer of its own; others may share it)
+            if (_idleCountdown != 0 && _overlayMode == OVERLAY_NONE &&
+#if SSFD_BLINK
+                !_blinkEnabled &&
+#endif
+                _fadeFrames == 0 && _timer->hasSingleClient() && --_idleCountdown == 0)
+            {
+                _idling = true;
+                _timer->setRate((uint32_t)_idleHz * _scanPeriod);
+            }
+        }
+
+        const uint8_t *source = _overlayMode != OVERLAY_NONE ? _overlay : _frames[_frontFrame];
+        if (_scanDirty || source != _scanSource)
+        {
+            buildScanList(source);
+        }
+
+        // Blank stop: nothing to show, so nothing needs the timer until
+        // wake() restarts it
+        if (_blankStop && _scanLit == 0 && _overlayMode == OVERLAY_NONE && _timer != nullptr)
+        {
+            drive(0, 0);
+            flushOutput();
+            _timerGated = true;
 
-    // Read pattern for current digit (volatile safe)
-    uint8_t pattern = _displayPatterns[_currentDigit];
+            // A shared timer keeps running for the displays still lit
+            if (_timer->activeClients() == 0)
+            {
+                _timer->stop();
+            }
+            return true;
+        }
+    }
 
-    // Set all segment pins according to pattern
-    for (uint8_t bit = 0; bit < NUM_SEGMENTS; bit++)
+    uint8_t line = _scanList[_scanSlot];
+    if (line == SCAN_DARK)
     {
-        uint8_t pin = pgm_read_byte(&_segmentPins[bit]);
-        if (pattern & (1 << (7 - bit)))
+        // Consecutive dark slots: the digits are already off
+        if (!_scanDarkDriven)
         {
-            digitalWrite(pin, HIGH);
+            drive(0, 0);
+            _scanDarkDriven = true;
+
+            // A deferred output (74HC595) shows the last lit digit only now:
+            // leave this tick to it at the base period
+            if (_deferredOutput)
+            {
+                return _scanSlot + 1 >= _scanSlots;
+            }
         }
-        else
+        else if (_deferredOutput)
         {
-            digitalWrite(pin, LOW);
+            // Latch the queued dark pair before the period is stretched
+            flushOutput();
         }
+
+        // Cover the remaining dark slots with as few periods as the backend
+        // allows (not on a shared timer, where other displays need the ticks)
+        uint8_t darkSlots = _scanSlots - _scanSlot;
+        if (darkSlots > 1 && _timer != nullptr && _timer->hasSingleClient())
+        {
+            uint8_t covered = _timer->stretchTick(darkSlots);
+            if (covered > 1)
+            {
+                _scanStretched = true;
+                _scanSlot += covered - 1;
+                _frameTicks += covered - 1;
+            }
+        }
+        return _scanSlot + 1 >= _scanSlots;
     }
 
-    digitalWrite(pgm_read_byte(&_digitPins[_currentDigit]), HIGH);
-}
+    _scanDarkDriven = false;
+    if (_scanOrder == ScanOrder::SEGMENTS)
+    {
+        // One segment line on the digits that use it; several digits share
+        // the tick, so they keep the display brightness
+        uint8_t digitMask = _segmentDigits[line];
+#if SSFD_BLINK
+        if (_overlayMode != OVERLAY_WIRING)
+        {
+            digitMask &= ~_blinkHidden;
+        }
+#endif
+        drive((uint8_t)(0x80 >> line), digitMask);
+        return _scanSlot + 1 >= _scanSlots;
+    }
 
-// ========== clear() ==========
-void SevenSegment::clear()
-{
-    uint8_t blankPattern = pgm_read_byte(&SEGMENT_PATTERNS[10]);
-    cli();
-    for (uint8_t i = 0; i < NUM_DIGITS; i++)
+    uint8_t digitBit = 1 << line;
+#if SSFD_BLINK
+    if ((_blinkHidden & digitBit) && _overlayMode != OVERLAY_WIRING)
     {
-        _displayPatterns[i] = blankPattern;
+        drive(0, 0);
+    }
+    else
+#endif
+    {
+        drive(_scanSource[line], digitBit);
+
+        // Per-digit level: the compare point of this digit's own tick
+        // (unless other displays are lit in the same tick)
+        if (_digitDimmed &&
+            (_timer->hasSingleClient() || _timer->_schedule == SSFDTimer::Schedule::ROUND_ROBIN))
+        {
+            _timer->tickDuty(_digitDuty[line]);
+        }
     }
-    sei();
+    return _scanSlot + 1 >= _scanSlots;
 }
 
-// ========== testWiring() ==========
-void SevenSegment::testWiring(unsigned int delayMs)
+// ========== buildScanList() ==========
+void SevenSegmentBase::buildScanList(const uint8_t *source)
 {
-    if (!_isrActive)
+    _scanSource = source;
+    _scanDirty = false;
+
+    uint8_t slots = 0;
+    uint8_t lit = 0;
+    ScanMode mode = _scanMode;
+    if (_scanOrder == ScanOrder::SEGMENTS)
     {
-        return;
+        // Transpose the frame: the digits each segment line lights. A line
+        // no digit uses is the blank slot of this order
+        for (uint8_t s = 0; s < NUM_SEGMENTS; s++)
+        {
+            uint8_t segmentBit = 0x80 >> s;
+            uint8_t digits = 0;
+            for (uint8_t i = 0; i < _numDigits; i++)
+            {
+                if (source[i] & segmentBit)
+                {
+                    digits |= 1 << i;
+                }
+            }
+            _segmentDigits[s] = digits;
+            if (digits != 0)
+            {
+                lit++;
+            }
+            if (mode == ScanMode::FULL || digits != 0)
+            {
+                _scanList[slots++] = s;
+            }
+        }
     }
+    else
+    {
+        for (uint8_t i = 0; i < _numDigits; i++)
+        {
+            if (source[i] != PATTERN_BLANK)
+            {
+                lit++;
+            }
 
-    cli();
-    TIMSK1 &= ~(1 << OCIE1A);
-
-    for (uint8_t d = 0; d < NUM_DIGITS; d++)
+            // Blink-hidden digits stay in the list so brightness does not pump
+            if (mode == ScanMode::FULL || source[i] != PATTERN_BLANK)
+            {
+                _scanList[slots++] = i;
+            }
+        }
+    }
+    _scanLit = lit;
+
+    // Dark slots pad the scan to the timer's frame: blank digits under
+    // SKIP_FEWER_TICKS (merged into one stretched tick by multiplex()), and
+    // the extra ticks a wider display on the same timer needs. Only
+    // SKIP_BRIGHTER shortens the scan, and not while the displays take turns
+    bool shorten = mode == ScanMode::SKIP_BRIGHTER &&
+                   (_timer == nullptr || _timer->_schedule != SSFDTimer::Schedule::ROUND_ROBIN);
+    uint8_t end = shorten ? (slots > 0 ? slots : 1) : _scanPeriod;
+    while (slots < end)
     {
-        digitalWrite(pgm_read_byte(&_digitPins[d]), HIGH);
+        _scanList[slots++] = SCAN_DARK;
     }
+    _scanSlots = slots;
+}
 
-    for (uint8_t s = 0; s < NUM_SEGMENTS; s++)
+#if SSFD_STATS
+// ========== recordTick() ==========
+void SevenSegmentBase::recordTick(uint16_t latencyCycles, uint16_t cycles, bool overrun)
+{
+    _stats.ticks++;
+    if (cycles < _stats.minCycles)
+        _stats.minCycles = cycles;
+    if (cycles > _stats.maxCycles)
+        _stats.maxCycles = cycles;
+    if (latencyCycles < _stats.minLatency)
+        _stats.minLatency = latencyCycles;
+    if (latencyCycles > _stats.maxLatency)
+        _stats.maxLatency = latencyCycles;
+    if (overrun && _stats.missedTicks != 0xFFFF)
+        _stats.missedTicks++;
+
+    // Running sum for the mean; halve both terms before it can overflow
+    if (_statsCycleSum >= 0x80000000UL)
     {
-        digitalWrite(pgm_read_byte(&_segmentPins[s]), HIGH);
-        sei();
-        delay(delayMs);
-        cli();
-        digitalWrite(pgm_read_byte(&_segmentPins[s]), LOW);
+        _statsCycleSum >>= 1;
+        _statsSumTicks >>= 1;
     }
+    _statsCycleSum += cycles;
+    _statsSumTicks++;
+}
 
-    for (uint8_t d = 0; d < NUM_DIGITS; d++)
+// ========== getStats() ==========
+SevenSegmentBase::Stats SevenSegmentBase::getStats() const
+{
+    Stats snapshot;
+    uint32_t sum;
+    uint32_t sumTicks;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
     {
-        digitalWrite(pgm_read_byte(&_digitPins[d]), LOW);
+        snapshot = _stats;
+        snapshot.resolution = _statsResolution;
+        sum = _statsCycleSum;
+        sumTicks = _statsSumTicks;
     }
 
-    TIMSK1 |= (1 << OCIE1A);
-    sei();
+    // Division happens here, in the main context, never in the ISR
+    if (snapshot.ticks == 0)
+    {
+        snapshot.minCycles = 0;
+        snapshot.minLatency = 0;
+        snapshot.meanCycles = 0;
+        snapshot.jitter = 0;
+        return snapshot;
+    }
+    snapshot.meanCycles = (uint16_t)((sum + sumTicks / 2) / sumTicks);
+    snapshot.jitter = snapshot.maxLatency - snapshot.minLatency;
+    return snapshot;
 }
 
-// ========== setNumber() ==========
-void SevenSegment::setNumber(uint16_t value, int8_t dpPosition)
+// ========== resetStats() ==========
+void SevenSegmentBase::resetStats()
 {
-    // Bounds checking
-    if (value > MAX_VALUE)
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
     {
-        value = MAX_VALUE;
+        memset(&_stats, 0, sizeof(_stats));
+        _stats.minCycles = 0xFFFF;
+        _stats.minLatency = 0xFFFF;
+        _statsCycleSum = 0;
+        _statsSumTicks = 0;
     }
-    if (dpPosition < -1 || dpPosition > 3)
+}
+#endif
+
+// ========== clear() ==========
+void SevenSegmentBase::clear()
+{
+    _lineEnded = true;
+    if (isRepeatCall(SET_CLEAR, 0, 0))
     {
-        dpPosition = -1;
+        return;
     }
 
-    // Extract digits
-    uint8_t digits[NUM_DIGITS];
-    uint16_t temp = value;
-    for (int8_t i = NUM_DIGITS - 1; i >= 0; i--)
+    uint8_t *frame = backFrame();
+    for (uint8_t i = 0; i < _numDigits; i++)
     {
-        digits[i] = temp % 10;
-        temp /= 10;
+        frame[i] = PATTERN_BLANK;
     }
+    publishFrame();
+    rememberCall(SET_CLEAR, 0, 0);
+}
 
-    // Build patterns with leading zero suppression
-    bool isLeading = true;
-    cli();
-    for (uint8_t i = 0; i < NUM_DIGITS; i++)
+// ========== testWiring() ==========
+void SevenSegmentBase::testWiring(unsigned int delayMs)
+{
+    if (!_isrActive)
     {
-        uint8_t digit = digits[i];
-        uint8_t pattern = pgm_read_byte(&SEGMENT_PATTERNS[digit]);
+        return;
+    }
 
-        // Suppress leading zeros if enabled
-        if (!_leadingZeros && digit == 0 && isLeading && i < NUM_DIGITS - 1)
-        {
-            pattern = pgm_read_byte(&SEGMENT_PATTERNS[10]);
-        }
-        else if (digit != 0 || !isLeading || i == NUM_DIGITS - 1)
+    // Gating keeps the ISR off this display; only a timer it has to itself
+    // is stopped, one shared with other displays keeps scanning them
+    bool wasGated = false;
+    if (_timer != nullptr)
+    {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
         {
-            isLeading = false;
+            wasGated = _timerGated;
+            _timerGated = true;
         }
-
-        if (i == dpPosition && dpPosition >= 0)
+        if (!wasGated && _timer->hasSingleClient())
         {
-            pattern |= pgm_read_byte(&SEGMENT_PATTERNS[11]); // OR with DP
+            _timer->stop();
         }
-
-        _displayPatterns[i] = pattern;
     }
-    sei();
-}
 
-// ========== setFloat() ==========
-SevenSegment::Error SevenSegment::setFloat(float value)
-{
-    // Check for NaN or Inf
-    if (isnan(value) || isinf(value))
+    // Light each segment (a-g, then dp) on all digits at once
+    for (uint8_t s = 0; s < NUM_SEGMENTS; s++)
     {
-        setText("Err ");
-        return _lastError = Error::INVALID_ARGUMENT;
+        drive(0x80 >> s, allDigits());
+        flushOutput();
+        delay(delayMs);
     }
 
-    // Handle negative numbers
-    if (value < 0.0f)
+    drive(0, 0);
+    flushOutput();
+
+    if (_timer != nullptr)
     {
-        // We can only show 3 digits and a negative sign
-        if (value <= -100.0f)
-        {
-            setText("-999"); 
-        }
-        else
+        // A blank-gated display stays gated until wake(); otherwise restart
+        // the timer only if no other display kept it running
+        if (!wasGated)
         {
-            uint16_t numToDisplay;
-            int8_t dpPosition;
-            if (value > -10.0f)
+            bool restart;
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
             {
-                numToDisplay = (uint16_t)roundf(fabs(value) * 100.0f);
-                dpPosition = 1;
+                _timerGated = false;
+                restart = _timer->activeClients() == 1;
             }
-            else
+            if (restart)
             {
-                numToDisplay = (uint16_t)roundf(fabs(value) * 10.0f);
-                dpPosition = 2;
+                _timer->start((uint32_t)_refreshHz * _timer->ticksPerFrame());
             }
-            setNumber(numToDisplay, dpPosition);
-            cli();
-            _displayPatterns[0] = getPattern('-');
-            sei();
-        }
-        return _lastError = Error::OK;
-    }
-
-    // Handle positive numbers
-    uint16_t numToDisplay;
-    int8_t dpPosition = -1;
-    int intPart = (int)value;
-    int numIntDigits = 1;
-
-    if (intPart >= 1000)
-        numIntDigits = 4;
-    else if (intPart >= 100)
-        numIntDigits = 3;
-    else if (intPart >= 10)
-        numIntDigits = 2;
-
-    // The number of decimals we can show is 4 - numIntDigits
-    int numDecimals = 4 - numIntDigits;
-    if (numDecimals < 0)
-        numDecimals = 0;
-
-    dpPosition = numIntDigits - 1; // 0="X.XXX", 1="XX.XX", 2="XXX.X", 3="XXXX"
-    if (dpPosition == 3)
-        dpPosition = -1;
-
-    double multiplier = pow(10, numDecimals);
-    numToDisplay = (uint16_t)round(value * multiplier);
-
-    if (numToDisplay > 9999)
+        }
+    }
+    else if (_selfRefreshing)
     {
-        numToDisplay = 9999;
+        frameUpdated(_frames[_frontFrame], nullptr);
     }
-
-    setNumber(numToDisplay, dpPosition);
-    return _lastError = Error::OK;
 }
 
-// ========== setText() ==========
-SevenSegment::Error SevenSegment::setText(const char *text)
+// ========== startWiringTest() ==========
+SevenSegmentBase::Error SevenSegmentBase::startWiringTest(uint16_t stepMs, ScrollCallback done)
 {
-    if (text == nullptr)
+    if (_selfRefreshing)
     {
-        return Error::NULL_POINTER;
+        return _lastError = Error::NOT_SUPPORTED;
     }
 
-    uint8_t len = strlen(text);
-    if (len > NUM_DIGITS)
+    // Same handover as startScroll(), except that the overlay it replaces
+    // is kept to resume afterwards
+    uint8_t resume = _overlayMode;
+    if (resume == OVERLAY_WIRING)
     {
-        return Error::INVALID_ARGUMENT;
+        resume = _testResume;
     }
+    _overlayMode = OVERLAY_NONE;
+    compilerBarrier();
+
+    _testStep = 0;
+    _testInterval = stepMs;
+    _testFrames = framesFor(stepMs);
+    _testCountdown = _testFrames;
+    _testResume = resume;
+    _testDone = done;
+    renderWiringTest();
+
+    compilerBarrier();
+    _overlayMode = OVERLAY_WIRING;
+    wake();
+    return _lastError = Error::OK;
+}
 
-    char padded[NUM_DIGITS + 1] = {' ', ' ', ' ', ' ', '\0'};
-    strncpy(padded, text, len);
-
-    cli();
-    for (uint8_t i = 0; i < NUM_DIGITS; i++)
+// ========== stopWiringTest() ==========
+void SevenSegmentBase::stopWiringTest()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
     {
-        _displayPatterns[i] = getPattern(padded[i]);
+        if (_overlayMode == OVERLAY_WIRING)
+        {
+            resumeAfterWiringTest();
+        }
     }
-    sei();
-
-    return Error::OK;
 }
 
-// ========== setSegments() ==========
-void SevenSegment::setSegments(const uint8_t patterns[NUM_DIGITS])
+// ========== stepWiringTest() ==========
+void SevenSegmentBase::stepWiringTest()
 {
-    if (patterns == nullptr)
+    if (--_testCountdown != 0)
     {
         return;
     }
+    _testCountdown = _testFrames;
 
-    cli();
-    for (uint8_t i = 0; i < NUM_DIGITS; i++)
+    if (++_testStep < NUM_SEGMENTS + _numDigits)
     {
-        _displayPatterns[i] = patterns[i];
+        renderWiringTest();
+        return;
     }
-    sei();
-}
 
-// ========== setHundredths() ==========
-void SevenSegment::setHundredths(uint16_t hundredths, int8_t dpPosition)
-{
-    if (hundredths > 9999)
-    {
-        hundredths = 9999;
-    }
-    if (dpPosition < -1 || dpPosition > 3)
+    resumeAfterWiringTest();
+    if (_testDone != nullptr)
     {
-        dpPosition = 2; // Default to 2 decimal places
+        _testDone();
     }
-
-    setNumber(hundredths, dpPosition);
 }
 
-// ========== getPattern() ==========
-uint8_t SevenSegment::getPattern(char c)
+// ========== resumeAfterWiringTest() ==========
+void SevenSegmentBase::resumeAfterWiringTest()
 {
-    // Map character to pattern index
-    uint8_t index = 10;
-
-    if (c >= '0' && c <= '9')
-    {
-        index = c - '0'; // 0-9
-    }
-    else if (c >= 'A' && c <= 'Z')
-    {
-        index = 12 + (c - 'A'); // A-Z (indices 12-37)
-    }
-    else if (c >= 'a' && c <= 'z')
-    {
-        index = 12 + (c - 'a'); // Treat lowercase same as uppercase
-    }
-    else if (c == ' ')
+    // The paused mode's state was left alone; redraw its step over the
+    // test pattern before showing it again
+#if SSFD_MARQUEE
+    if (_testResume == OVERLAY_SCROLL)
     {
-        index = 38; // SPACE
+        renderScroll();
     }
-    else if (c == '-')
+#endif
+#if SSFD_ANIMATION
+    if (_testResume == OVERLAY_ANIMATION)
     {
-        index = 39; // DASH
+        memcpy_P(_overlay, _anim.frames + (uint16_t)_animIndex * _numDigits, _numDigits);
     }
-    else if (c == '=')
+#endif
+#if SSFD_COUNTER
+    if (_testResume == OVERLAY_COUNTER)
     {
-        index = 40; // EQUALS
+        renderCounter();
     }
-    else if (c == '.')
+#endif
+    _overlayMode = _testResume;
+    _scanDirty = true;
+}
+
+// ========== renderWiringTest() ==========
+void SevenSegmentBase::renderWiringTest()
+{
+    // One segment (a-g, dp) on every digit, then one whole digit at a time
+    for (uint8_t i = 0; i < _numDigits; i++)
     {
-        index = 11; // DP only
+        if (_testStep < NUM_SEGMENTS)
+        {
+            _overlay[i] = 0x80 >> _testStep;
+        }
+        else
+        {
+            _overlay[i] = i == _testStep - NUM_SEGMENTS ? 0xFF : PATTERN_BLANK;
+        }
     }
+    _scanDirty = true;
+}
 
-    // Bounds check
-    if (index >= (sizeof(SEGMENT_PATTERNS) / sizeof(SEGMENT_PATTERNS[0])))
+// ========== setNumber() ==========
+void SevenSegmentBase::setNumber(uint16_t value, int8_t dpPosition)
+{
+    if (isRepeatCall(SET_NUMBER, value, dpPosition))
     {
-        index = 10;
+        return;
     }
 
-    return pgm_read_byte(&SEGMENT_PATTERNS[index]);
+    composeNumber(backFrame(), value, dpPosition);
+    publishFrame();
+    rememberCall(SET_NUMBER, value, dpPosition);
 }
 
-// ========== setLeadingZeros() ==========
-void SevenSegment::setLeadingZeros(bool enabled)
+// ========== DECIMAL HELPERS ==========
+// 10^n for n = 0..8: the values that fit n digits are 0..10^n - 1
+static const uint32_t DECIMAL_LIMIT[] PROGMEM = {
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL};
+
+#if SSFD_FLOAT
+// Float scale factors for 0..7 decimals (replaces pow(); no libm needed)
+static const float FLOAT_SCALE[] PROGMEM = {1.0f, 10.0f, 100.0f, 1000.0f,
+                                            1e4f, 1e5f, 1e6f, 1e7f};
+#endif
+
+static inline uint32_t decimalLimit(uint8_t digits)
 {
-    _leadingZeros = enabled;
+    return pgm_read_dword(&DECIMAL_LIMIT[digits]);
 }
 
-// ========== setRefreshInterval() ==========
-void SevenSegment::setRefreshInterval(uint8_t ms)
+#if SSFD_TEXT
+// Font index of each nibble, so hex goes through the (replaceable) font
+static const char HEX_CHARS[16] PROGMEM = {'0', '1', '2', '3', '4', '5', '6', '7',
+                                           '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
+static inline uint8_t hexPattern(uint8_t nibble)
 {
-    if (ms < 1)
-        ms = 1;
-    if (ms > 255)
-        ms = 255;
-    _refreshIntervalMs = ms;
+    return pgm_read_byte(&ssfdFont[(uint8_t)pgm_read_byte(&HEX_CHARS[nibble])]);
 }
 
-// ========== startBlink() ==========
-void SevenSegment::startBlink(unsigned long intervalMs)
+static inline uint8_t digitPattern(uint8_t digit)
 {
-    _blinkInterval = intervalMs;
-    _blinkEnabled = true;
-    _blinkStateOn = true;
-    _blinkLastToggle = millis();
+    return pgm_read_byte(&ssfdFont['0' + digit]);
+}
+#else
+static inline uint8_t hexPattern(uint8_t nibble)
+{
+    return pgm_read_byte(&HEX_FONT[nibble]);
 }
 
-// ========== stopBlink() ==========
-void SevenSegment::stopBlink()
+static inline uint8_t digitPattern(uint8_t digit)
 {
-    _blinkEnabled = false;
-    _blinkStateOn = true;
-}
\ No newline at end of file
+    return hexPattern(digit);
+}
+#endif
+
+/**
+ * Divide by 10 with shifts and adds only (no software division)
+ */
+static uint32_t div10(uint32_t n, uint8_t &remainder)
+{
+    uint32_t q = (n >> 1) + (n >> 2);
+    q += q >> 4;
+    q += q >> 8;
+    q += q >> 16;
+    q >>= 3;
+    uint32_t r = n - ((q << 3) + (q << 1)); // n - q * 10
+    if (r > 9)
+    {
+        q++;
+        r -= 10;
+    }
+    remainder = (uint8_t)r;
+    return q;
+}
+
+// ========== splitDecimal() ==========
+/**
+ * Split 0..9999 into four decimal digits without calling the software
+ * division routine. value / 100 is a multiply by 5243 / 2^19 (exact below
+ * 43699); each 0..99 half is then split with a multiply by 205 / 2^11
+ * (exact below 1029), which fits the AVR 8x8 hardware multiplier.
+ */
+static void splitDecimal(uint16_t value, uint8_t digits[4])
+{
+    uint8_t hi = (uint8_t)(((uint32_t)value * 5243) >> 19); // value / 100
+    uint8_t lo = (uint8_t)(value - hi * 100);                // value % 100
+
+    uint8_t tens = (uint8_t)(((uint16_t)hi * 205) >> 11);
+    digits[0] = tens;
+    digits[1] = hi - tens * 10;
+
+    tens = (uint8_t)(((uint16_t)lo * 205) >> 11);
+    digits[2] = tens;
+    digits[3] = lo - tens * 10;
+}
+
+// ========== composeNumber() ==========
+void SevenSegmentBase::composeNumber(uint8_t *frame, uint32_t value, int8_t dpPosition)
+{
+    const uint8_t count = _numDigits;
+
+    // Bounds checking
+    uint32_t limit = decimalLimit(count);
+    if (value >= limit)
+    {
+        value = limit - 1;
+    }
+    if (dpPosition < -1 || dpPosition >= (int8_t)count)
+    {
+        dpPosition = -1;
+    }
+
+    // Extract digits (no division); the 4-digit split is the fast path
+    uint8_t digits[MAX_DIGITS];
+    if (count == 4)
+    {
+        splitDecimal((uint16_t)value, digits);
+    }
+    else
+    {
+        for (uint8_t i = count; i-- > 0;)
+        {
+            value = div10(value, digits[i]);
+        }
+    }
+
+    // Build patterns with leading zero suppression
+    bool isLeading = true;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint8_t digit = digits[i];
+        uint8_t pattern = digitPattern(digit);
+
+        // Suppress leading zeros if enabled (never the units digit, which
+        // is the last digit or the one carrying the decimal point)
+        bool isUnits = (i == count - 1) || (i == dpPosition);
+        if (!_leadingZeros && digit == 0 && isLeading && !isUnits)
+        {
+            pattern = PATTERN_BLANK;
+        }
+        else if (digit != 0 || !isLeading || isUnits)
+        {
+            isLeading = false;
+        }
+
+        if (i == dpPosition && dpPosition >= 0)
+        {
+            pattern |= PATTERN_DP;
+        }
+
+        frame[i] = pattern;
+    }
+}
+
+#if SSFD_FLOAT
+// ========== setFloat() ==========
+SevenSegmentBase::Error SevenSegmentBase::setFloat(float value)
+{
+    // Same bit pattern, same frame (NaN included)
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if (isRepeatCall(SET_FLOAT, bits, 0))
+    {
+        return _lastCall.result;
+    }
+
+    Error result = formatFloat(value);
+    rememberCall(SET_FLOAT, bits, 0, result);
+    return result;
+}
+
+// ========== formatFloat() ==========
+SevenSegmentBase::Error SevenSegmentBase::formatFloat(float value)
+{
+    // NaN and +/-Inf are the only values for which x - x != 0
+    if (!(value - value == 0.0f))
+    {
+#if SSFD_TEXT
+        setText(_numDigits >= 3 ? "Err" : "E");
+#else
+        // No font: the built-in "Err" glyphs, padded with blanks
+        uint8_t *frame = backFrame();
+        memset(frame, PATTERN_BLANK, _numDigits);
+        frame[0] = 0b10011110; // E
+        if (_numDigits >= 3)
+        {
+            frame[1] = frame[2] = 0b00001010; // r
+        }
+        publishFrame();
+#endif
+        return _lastError = Error::INVALID_ARGUMENT;
+    }
+
+    // The sign takes the first cell
+    bool negative = value < 0.0f;
+    const uint8_t cells = negative ? _numDigits - 1 : _numDigits;
+    const uint32_t limit = decimalLimit(cells);
+    if (negative)
+    {
+        value = -value;
+
+        // Saturate to "-999" (4 digits) from the first value without a decimal
+        if (value >= (float)(limit / 10))
+        {
+            publishDecimal(true, limit - 1, 0);
+            return _lastError = Error::OK;
+        }
+    }
+
+    // Most decimals that fit: "X.XXX", "XX.XX", "XXX.X", "XXXX" on 4 digits
+    // (one digit fewer when the sign takes the first cell)
+    uint8_t decimals = cells > 0 ? cells - 1 : 0;
+    float bound = 10.0f;
+    while (decimals > 0 && value >= bound)
+    {
+        decimals--;
+        bound *= 10.0f;
+    }
+
+    // One float multiply and a truncating add-half replace pow() / round()
+    float scaled = value * pgm_read_float(&FLOAT_SCALE[decimals]) + 0.5f;
+    uint32_t digitsValue = scaled < (float)limit ? (uint32_t)scaled : limit;
+
+    // Rounding carried into a new digit (e.g. 9.9996 -> 10.00)
+    if (digitsValue >= limit)
+    {
+        if (decimals > 0)
+        {
+            digitsValue = limit / 10;
+            decimals--;
+        }
+        else
+        {
+            digitsValue = limit - 1;
+        }
+    }
+
+    publishDecimal(negative, digitsValue, decimals);
+    return _lastError = Error::OK;
+}
+#endif
+
+// ========== setFixed() ==========
+SevenSegmentBase::Error SevenSegmentBase::setFixed(int32_t mantissa, int8_t exponent)
+{
+    if (isRepeatCall(SET_FIXED, (uint32_t)mantissa, exponent))
+    {
+        return _lastCall.result;
+    }
+
+    Error result = formatFixed(mantissa, exponent);
+    rememberCall(SET_FIXED, (uint32_t)mantissa, exponent, result);
+    return result;
+}
+
+// ========== formatFixed() ==========
+SevenSegmentBase::Error SevenSegmentBase::formatFixed(int32_t mantissa, int8_t exponent)
+{
+    bool negative = mantissa < 0;
+    uint32_t magnitude = negative ? (uint32_t)0 - (uint32_t)mantissa : (uint32_t)mantissa;
+
+    // Same layout as setFloat(): every digit, or sign + the rest
+    const uint8_t cells = negative ? _numDigits - 1 : _numDigits;
+    const uint32_t limit = decimalLimit(cells);
+    const uint8_t maxDecimals = cells > 0 ? cells - 1 : 0;
+    bool overflow = false;
+    uint8_t decimals = 0;
+
+    if (exponent >= 0)
+    {
+        // Scale up; anything that reaches the limit is out of range
+        while (exponent-- > 0 && magnitude < limit)
+        {
+            magnitude = (magnitude << 3) + (magnitude << 1);
+        }
+        overflow = magnitude >= limit;
+    }
+    else
+    {
+        // Drop decimals that do not fit, rounding half up on the last one
+        decimals = (uint8_t)(-exponent);
+        uint8_t dropped = 0;
+        while (decimals > maxDecimals || (decimals > 0 && magnitude >= limit))
+        {
+            magnitude = div10(magnitude, dropped);
+            decimals--;
+        }
+        if (dropped >= 5)
+        {
+            magnitude++;
+        }
+
+        // Rounding carried into a new digit
+        if (magnitude >= limit)
+        {
+            if (decimals > 0)
+            {
+                magnitude = limit / 10;
+                decimals--;
+            }
+            else
+            {
+                overflow = true;
+            }
+        }
+    }
+
+    if (overflow)
+    {
+        // "9999" / "-999" on 4 digits
+        publishDecimal(negative, limit - 1, 0);
+        return _lastError = Error::INVALID_ARGUMENT;
+    }
+
+    publishDecimal(negative, magnitude, decimals);
+    return _lastError = Error::OK;
+}
+
+// ========== setInt() ==========
+SevenSegmentBase::Error SevenSegmentBase::setInt(int16_t value)
+{
+    if (isRepeatCall(SET_INT, (uint32_t)value, 0))
+    {
+        return _lastCall.result;
+    }
+
+    // Every digit, or sign + the rest
+    bool negative = value < 0;
+    uint16_t magnitude = negative ? (uint16_t)0 - (uint16_t)value : (uint16_t)value;
+    const uint32_t limit = decimalLimit(negative ? _numDigits - 1 : _numDigits);
+
+    Error result = Error::OK;
+    if (magnitude >= limit)
+    {
+        magnitude = (uint16_t)(limit - 1);
+        result = Error::INVALID_ARGUMENT;
+    }
+
+    publishDecimal(negative, magnitude, 0);
+    rememberCall(SET_INT, (uint32_t)value, 0, result);
+    return _lastError = result;
+}
+
+// ========== setHex() ==========
+SevenSegmentBase::Error SevenSegmentBase::setHex(uint16_t value)
+{
+    const uint16_t call = value;
+    if (isRepeatCall(SET_HEX, call, 0))
+    {
+        return _lastCall.result;
+    }
+
+    // Four nibbles, fewer on a narrower display
+    uint8_t nibbles = _numDigits < 4 ? _numDigits : 4;
+    Error result = Error::OK;
+    if (nibbles < 4 && (value >> (nibbles << 2)) != 0)
+    {
+        value = 0xFFFF;
+        result = Error::INVALID_ARGUMENT;
+    }
+
+    // Right-aligned, lowest nibble last; blanks to the left of the four
+    uint8_t *frame = backFrame();
+    uint8_t i = _numDigits;
+    while (nibbles--)
+    {
+        frame[--i] = hexPattern(value & 0x0F);
+        value >>= 4;
+    }
+    while (i > 0)
+    {
+        frame[--i] = PATTERN_BLANK;
+    }
+    publishFrame();
+
+    rememberCall(SET_HEX, call, 0, result);
+    return _lastError = result;
+}
+
+// ========== publishDecimal() ==========
+void SevenSegmentBase::publishDecimal(bool negative, uint32_t digitsValue, uint8_t decimals)
+{
+    // Decimal point after digit (digits - 1 - decimals); none for integers
+    int8_t dpPosition = decimals > 0 ? (int8_t)(_numDigits - 1 - decimals) : -1;
+
+    uint8_t *frame = backFrame();
+    composeNumber(frame, digitsValue, dpPosition);
+    if (negative)
+    {
+        frame[0] = getPattern('-');
+    }
+    publishFrame();
+}
+
+#if SSFD_TEXT
+// ========== setText() ==========
+SevenSegmentBase::Error SevenSegmentBase::setText(const char *text)
+{
+    if (text == nullptr)
+    {
+        return Error::NULL_POINTER;
+    }
+
+    size_t len = strlen(text);
+    if (len > _numDigits)
+    {
+        return Error::INVALID_ARGUMENT;
+    }
+
+    // Shorter text is padded with blanks on the right
+    uint8_t *frame = backFrame();
+    for (uint8_t i = 0; i < _numDigits; i++)
+    {
+        frame[i] = i < len ? getPattern(text[i]) : PATTERN_BLANK;
+    }
+    publishFrame();
+
+    return Error::OK;
+}
+#endif
+
+// ========== setSegments() ==========
+void SevenSegmentBase::setSegments(const uint8_t patterns[NUM_DIGITS])
+{
+    if (patterns == nullptr)
+    {
+        return;
+    }
+
+    uint8_t *frame = backFrame();
+    for (uint8_t i = 0; i < _numDigits; i++)
+    {
+        frame[i] = patterns[i];
+    }
+    publishFrame();
+}
+
+// ========== setHundredths() ==========
+void SevenSegmentBase::setHundredths(uint16_t hundredths, int8_t dpPosition)
+{
+    if (hundredths > 9999)
+    {
+        hundredths = 9999;
+    }
+    if (dpPosition < -1 || dpPosition >= (int8_t)_numDigits)
+    {
+        dpPosition = 2; // Out of range: fall back to the default position
+    }
+
+    setNumber(hundredths, dpPosition);
+}
+
+// ========== beginFrame() ==========
+void SevenSegmentBase::beginFrame(bool clear)
+{
+    openFrame(clear);
+    _cursor = 0;
+    _lineEnded = false;
+}
+
+// ========== openFrame() ==========
+void SevenSegmentBase::openFrame(bool clear)
+{
+    if (!_frameOpen)
+    {
+        // The newest frame is the pending one, unless the ISR swapped it in
+        // before the withdraw in backFrame() (then it is the front frame)
+        uint8_t front = _frontFrame;
+        bool pending = _framePending;
+        uint8_t *frame = backFrame();
+        if (!clear && !(pending && _frontFrame == front))
+        {
+            memcpy(frame, _frames[_frontFrame], _numDigits);
+        }
+        _frameOpen = true;
+    }
+
+    if (clear)
+    {
+        memset(backFrame(), PATTERN_BLANK, _numDigits);
+    }
+}
+
+#if SSFD_TEXT
+// ========== putChar() ==========
+SevenSegmentBase::Error SevenSegmentBase::putChar(uint8_t digit, char c)
+{
+    return stageDigit(digit, getPattern(c), 0);
+}
+#endif
+
+// ========== putDigit() ==========
+SevenSegmentBase::Error SevenSegmentBase::putDigit(uint8_t digit, uint8_t value)
+{
+    if (value > 15)
+    {
+        return Error::INVALID_ARGUMENT;
+    }
+    return stageDigit(digit, hexPattern(value), 0);
+}
+
+// ========== putDP() ==========
+SevenSegmentBase::Error SevenSegmentBase::putDP(uint8_t digit, bool on)
+{
+    return on ? stageDigit(digit, PATTERN_DP, 0xFF) : stageDigit(digit, 0, (uint8_t)~PATTERN_DP);
+}
+
+// ========== putRaw() ==========
+SevenSegmentBase::Error SevenSegmentBase::putRaw(uint8_t digit, uint8_t pattern)
+{
+    return stageDigit(digit, pattern, 0);
+}
+
+// ========== stageDigit() ==========
+SevenSegmentBase::Error SevenSegmentBase::stageDigit(uint8_t digit, uint8_t set, uint8_t keep)
+{
+    if (digit >= _numDigits)
+    {
+        return Error::INVALID_ARGUMENT;
+    }
+
+    // A lone put*() is a one-digit transaction on top of the latest frame
+    bool single = !_frameOpen;
+    if (single)
+    {
+        openFrame(false);
+    }
+
+    uint8_t *frame = backFrame();
+    frame[digit] = (frame[digit] & keep) | set;
+
+    if (single)
+    {
+        commit();
+    }
+    return Error::OK;
+}
+
+// ========== commit() ==========
+void SevenSegmentBase::commit()
+{
+    if (!_frameOpen)
+    {
+        return;
+    }
+    _frameOpen = false;
+    publishFrame();
+}
+
+// ========== write() ==========
+size_t SevenSegmentBase::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t SevenSegmentBase::write(const uint8_t *buffer, size_t size)
+{
+    if (buffer == nullptr)
+    {
+        return 0;
+    }
+
+    // The run is one frame (opened by the first character) unless
+    // beginFrame() already holds the commit
+    bool single = !_frameOpen;
+    size_t taken = 0;
+    while (size--)
+    {
+        if (streamChar(*buffer++))
+        {
+            taken++;
+        }
+    }
+
+    if (single)
+    {
+        commit();
+    }
+    return taken;
+}
+
+// ========== streamChar() ==========
+bool SevenSegmentBase::streamChar(uint8_t c)
+{
+    if (c == '\r')
+    {
+        return true;
+    }
+    if (c == '\n')
+    {
+        _lineEnded = true;
+        return true;
+    }
+
+    if (_lineEnded)
+    {
+        openFrame(true);
+        _cursor = 0;
+        _lineEnded = false;
+    }
+    else if (!_frameOpen)
+    {
+        openFrame(false);
+    }
+
+    uint8_t *frame = backFrame();
+
+    // "1.5" takes two cells; a second '.' or a leading one takes its own
+    if (c == '.' && _cursor > 0 && !(frame[_cursor - 1] & PATTERN_DP))
+    {
+        frame[_cursor - 1] |= PATTERN_DP;
+        return true;
+    }
+
+    if (_cursor >= _numDigits)
+    {
+        return false;
+    }
+    frame[_cursor++] = getPattern((char)c);
+    return true;
+}
+
+// ========== setCursor() ==========
+SevenSegmentBase::Error SevenSegmentBase::setCursor(uint8_t digit)
+{
+    if (digit >= _numDigits)
+    {
+        return Error::INVALID_ARGUMENT;
+    }
+    _cursor = digit;
+    _lineEnded = false;
+    return Error::OK;
+}
+
+// ========== backFrame() ==========
+uint8_t *SevenSegmentBase::backFrame()
+{
+    // Whatever is composed now replaces the frame of the remembered call
+    _lastCall.setter = SET_NONE;
+
+    // The open frame was claimed by beginFrame(); nothing is pending
+    if (_frameOpen)
+    {
+        return _frames[_frontFrame ^ 1];
+    }
+
+    // Withdraw any unpublished frame so the ISR cannot swap while we write.
+    // With no swap pending, _frontFrame is stable and the other buffer is ours.
+    _framePending = false;
+    compilerBarrier();
+    return _frames[_frontFrame ^ 1];
+}
+
+// ========== publishFrame() ==========
+void SevenSegmentBase::publishFrame()
+{
+    // Staged until commit()
+    if (_frameOpen)
+    {
+        return;
+    }
+    compilerBarrier();
+
+    // Nothing to republish if every glyph matches the frame on show (a
+    // withdrawn pending frame is simply dropped)
+    const uint8_t *back = _frames[_frontFrame ^ 1];
+    const uint8_t *front = _frames[_frontFrame];
+    if (memcmp(back, front, _numDigits) == 0)
+    {
+        countUpdate(false);
+        return;
+    }
+    countUpdate(true);
+
+    // Self-refreshing outputs: swap here and push the changed digits
+    if (_selfRefreshing)
+    {
+        _frontFrame ^= 1;
+        if (_isrActive)
+        {
+            frameUpdated(_frames[_frontFrame], _frames[_frontFrame ^ 1]);
+        }
+        return;
+    }
+
+    // Single-byte store; the ISR swaps buffers at the next digit-0 boundary
+    _framePending = true;
+    wake();
+}
+
+// ========== isRepeatCall() ==========
+bool SevenSegmentBase::isRepeatCall(uint8_t setter, uint32_t value, int8_t arg)
+{
+    if (_lastCall.setter != setter || _lastCall.value != value || _lastCall.arg != arg)
+    {
+        return false;
+    }
+    countUpdate(false);
+    return true;
+}
+
+// ========== rememberCall() ==========
+void SevenSegmentBase::rememberCall(uint8_t setter, uint32_t value, int8_t arg, Error result)
+{
+    _lastCall.setter = setter;
+    _lastCall.value = value;
+    _lastCall.arg = arg;
+    _lastCall.result = result;
+}
+
+// ========== getPattern() ==========
+uint8_t SevenSegmentBase::getPattern(char c)
+{
+#if SSFD_TEXT
+    // One flash read; no per-character branching
+    uint8_t code = (uint8_t)c;
+#if SSFD_FONT_SIZE < 256
+    if (code >= SSFD_FONT_SIZE)
+    {
+        return PATTERN_BLANK;
+    }
+#endif
+    return pgm_read_byte(&ssfdFont[code]);
+#else
+    // Numerals and the sign only: what the numeric setters and print() emit
+    if (c >= '0' && c <= '9')
+    {
+        return digitPattern(c - '0');
+    }
+    uint8_t letter = (uint8_t)(c | 0x20); // 'A'..'F' -> 'a'..'f'
+    if (letter >= 'a' && letter <= 'f')
+    {
+        return hexPattern(letter - 'a' + 10);
+    }
+    return c == '-' ? PATTERN_MINUS : PATTERN_BLANK;
+#endif
+}
+
+// ========== setLeadingZeros() ==========
+void SevenSegmentBase::setLeadingZeros(bool enabled)
+{
+    // The same setNumber() call now composes a different frame
+    _leadingZeros = enabled;
+    _lastCall.setter = SET_NONE;
+}
+
+// ========== setRefreshRate() ==========
+SevenSegmentBase::Error SevenSegmentBase::setRefreshRate(uint16_t hz)
+{
+    if (hz < MIN_REFRESH_HZ || hz > MAX_REFRESH_HZ)
+    {
+        return Error::INVALID_ARGUMENT;
+    }
+
+    // Retune a running backend; otherwise applied by the next begin()
+    if (_timer == nullptr)
+    {
+        adoptRefreshRate(hz);
+        return Error::OK;
+    }
+    if (!_timer->setRate((uint32_t)hz * _timer->ticksPerFrame()))
+    {
+        return Error::INVALID_ARGUMENT;
+    }
+
+    // Displays on one timer share its frame rate
+    for (SevenSegmentBase *display = _timer->_clients; display != nullptr;
+         display = display->_nextClient)
+    {
+        display->adoptRefreshRate(hz);
+    }
+    return Error::OK;
+}
+
+// ========== adoptRefreshRate() ==========
+void SevenSegmentBase::adoptRefreshRate(uint16_t hz)
+{
+#if SSFD_COUNTER
+    uint16_t oldHz = _refreshHz;
+    uint32_t counterPeriod = (uint32_t)_counterInterval * hz;
+#endif
+    _refreshHz = hz;
+
+    // Keep the blink and scroll periods in milliseconds at the new frame rate
+#if SSFD_BLINK
+    uint16_t blinkFrames = framesFor(_blinkInterval);
+#endif
+#if SSFD_MARQUEE
+    uint16_t scrollFrames = framesFor(_scrollInterval);
+#endif
+    uint16_t testFrames = framesFor(_testInterval);
+#if SSFD_ANIMATION
+    uint16_t animFrames = animationFramesFor(_anim.fps);
+    uint16_t animNextFrames = animationFramesFor(_animNext.fps);
+#endif
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+#if SSFD_BLINK
+        _blinkFrames = blinkFrames;
+#endif
+#if SSFD_MARQUEE
+        _scrollFrames = scrollFrames;
+#endif
+        _testFrames = testFrames;
+#if SSFD_ANIMATION
+        _anim.stepFrames = animFrames;
+        _animNext.stepFrames = animNextFrames;
+#endif
+#if SSFD_COUNTER
+        // Same time into the counter period at the new rate (never a burst
+        // of steps: the result stays below the new period)
+        if (_counterInterval != 0)
+        {
+            _counterElapsed = _counterElapsed / oldHz * hz;
+            _counterPeriod = counterPeriod;
+        }
+#endif
+
+        // The timer now runs at hz again; restart the idle countdown
+        _idling = false;
+        _idleCountdown = _timer != nullptr ? (uint32_t)_idleAfter * hz : 0;
+    }
+}
+
+// ========== setBrightness() ==========
+SevenSegmentBase::Error SevenSegmentBase::setBrightness(uint8_t level)
+{
+    _fadeFrames = 0;
+    return applyBrightness(level) ? Error::OK : Error::NOT_SUPPORTED;
+}
+
+// ========== fadeTo() ==========
+SevenSegmentBase::Error SevenSegmentBase::fadeTo(uint8_t level, uint16_t durationMs)
+{
+    if (_selfRefreshing)
+    {
+        return Error::NOT_SUPPORTED;
+    }
+
+    uint32_t frames = (uint32_t)durationMs * _refreshHz / 1000;
+    if (frames <= 1 || _timer == nullptr || !canDim())
+    {
+        return setBrightness(level);
+    }
+    if (frames > 0xFFFF)
+    {
+        frames = 0xFFFF;
+    }
+
+    // Start half a step in, so the integer level rounds to nearest
+    int16_t step = (int16_t)(((int32_t)level - _brightness) * 256 / (int32_t)frames);
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        _fadeTarget = level;
+        _fadeLevel = ((uint16_t)_brightness << 8) | 0x80;
+        _fadeStep = step;
+        _fadeFrames = (uint16_t)frames;
+    }
+
+    // An idling or blank-stopped timer would hold the fade back
+    wake();
+    return Error::OK;
+}
+
+// ========== stepFade() ==========
+void SevenSegmentBase::stepFade()
+{
+    _fadeLevel += (uint16_t)_fadeStep;
+    if (--_fadeFrames == 0)
+    {
+        _fadeLevel = (uint16_t)_fadeTarget << 8;
+    }
+
+    // Retune the compare channel only when the visible level moves
+    uint8_t level = (uint8_t)(_fadeLevel >> 8);
+    if (level != _brightness)
+    {
+        applyBrightness(level);
+    }
+}
+
+// ========== applyBrightness() ==========
+bool SevenSegmentBase::applyBrightness(uint8_t level)
+{
+    if (_selfRefreshing)
+    {
+        _brightness = level;
+        return outputBrightness(level);
+    }
+
+    // Not begun: begin() applies it
+    if (_timer == nullptr)
+    {
+        _brightness = level;
+        updateDigitDuty();
+        return true;
+    }
+
+    if (!_timer->setDuty(level))
+    {
+        return false;
+    }
+    for (SevenSegmentBase *display = _timer->_clients; display != nullptr;
+         display = display->_nextClient)
+    {
+        display->_brightness = level;
+        display->updateDigitDuty();
+    }
+    return true;
+}
+
+// ========== canDim() ==========
+bool SevenSegmentBase::canDim()
+{
+    if (_timer == nullptr)
+    {
+        return true;
+    }
+    return _timer->setDuty(SSFDTimer::FULL_DUTY - 1) && applyBrightness(_brightness);
+}
+
+// ========== setDigitBrightness() ==========
+SevenSegmentBase::Error SevenSegmentBase::setDigitBrightness(uint8_t digit, uint8_t level)
+{
+    if (digit >= _numDigits || level > MAX_DIGIT_LEVEL)
+    {
+        return Error::INVALID_ARGUMENT;
+    }
+    if (_selfRefreshing || !canDim())
+    {
+        return Error::NOT_SUPPORTED;
+    }
+
+    bool dimmed = false;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        _digitLevel[digit] = level;
+        updateDigitDuty();
+        for (uint8_t i = 0; i < _numDigits; i++)
+        {
+            dimmed = dimmed || _digitLevel[i] != MAX_DIGIT_LEVEL;
+        }
+        _digitDimmed = dimmed;
+    }
+
+    // Back to one level: the timer's own duty takes over again
+    if (!dimmed && _timer != nullptr)
+    {
+        applyBrightness(_brightness);
+    }
+    return Error::OK;
+}
+
+// ========== updateDigitDuty() ==========
+void SevenSegmentBase::updateDigitDuty()
+{
+    // level * 17 spans 0..255; the rounding term keeps 15 at full brightness
+    for (uint8_t i = 0; i < _numDigits; i++)
+    {
+        uint16_t weight = _digitLevel[i] * 17;
+        _digitDuty[i] = (uint8_t)((_brightness * weight + _brightness) >> 8);
+    }
+}
+
+// ========== setRefreshInterval() ==========
+void SevenSegmentBase::setRefreshInterval(uint8_t ms)
+{
+    if (ms < 1)
+        ms = 1;
+    if (ms > 1000 / MIN_REFRESH_HZ)
+        ms = 1000 / MIN_REFRESH_HZ;
+    setRefreshRate(1000 / ms);
+}
+
+// ========== setScanMode() ==========
+void SevenSegmentBase::setScanMode(ScanMode mode)
+{
+    // The ISR rebuilds its list at the next scan boundary
+    _scanMode = mode;
+    _scanDirty = true;
+}
+
+// ========== setBlankStop() ==========
+void SevenSegmentBase::setBlankStop(bool enabled)
+{
+    // Enabling takes effect at the next scan boundary (from the ISR)
+    _blankStop = enabled;
+    if (!enabled)
+    {
+        wake();
+    }
+}
+
+// ========== setIdleRefresh() ==========
+SevenSegmentBase::Error SevenSegmentBase::setIdleRefresh(uint16_t afterSeconds, uint16_t idleHz)
+{
+    if (idleHz < MIN_REFRESH_HZ || idleHz > MAX_REFRESH_HZ)
+    {
+        return Error::INVALID_ARGUMENT;
+    }
+
+    // The ISR only reads these once the countdown is re-armed by wake()
+    _idleCountdown = 0;
+    compilerBarrier();
+    _idleAfter = afterSeconds;
+    _idleHz = idleHz;
+    wake();
+    return Error::OK;
+}
+
+// ========== getTickRate() ==========
+uint32_t SevenSegmentBase::getTickRate() const
+{
+    if (!_isrActive || _timer == nullptr || _timer->activeClients() == 0)
+    {
+        return 0;
+    }
+    return (uint32_t)(_idling ? _idleHz : _refreshHz) * _timer->ticksPerFrame();
+}
+
+// ========== wake() ==========
+void SevenSegmentBase::wake()
+{
+    if (_timer == nullptr)
+    {
+        return;
+    }
+
+    // Something changed: restart the idle countdown at the normal rate
+    bool idling;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        idling = _idling;
+        _idling = false;
+        _idleCountdown = (uint32_t)_idleAfter * _refreshHz;
+    }
+    if (idling)
+    {
+        _timer->setRate((uint32_t)_refreshHz * _timer->ticksPerFrame());
+    }
+
+    // The ISR gates the timer only at a scan boundary, after picking up any
+    // published frame, so a frame published before this check is never lost
+    if (_timerGated)
+    {
+        // Ungate first: a display on the same timer gating itself meanwhile
+        // then sees this one active and leaves the timer running
+        bool restart;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            _timerGated = false;
+            restart = _timer->activeClients() == 1;
+        }
+        if (restart)
+        {
+            _timer->start((uint32_t)_refreshHz * _timer->ticksPerFrame());
+        }
+    }
+}
+
+// ========== framesFor() ==========
+uint16_t SevenSegmentBase::framesFor(unsigned long intervalMs) const
+{
+    uint32_t frames = (intervalMs * _refreshHz + 500) / 1000;
+    if (frames < 1)
+        frames = 1;
+    if (frames > 0xFFFF)
+        frames = 0xFFFF;
+    return (uint16_t)frames;
+}
+
+#if SSFD_BLINK
+// ========== startBlink() ==========
+void SevenSegmentBase::startBlink(unsigned long intervalMs, uint8_t digitMask)
+{
+    // The ISR ignores the counters while blinking is disabled, so they can
+    // be rewritten without masking interrupts
+    _blinkEnabled = false;
+    _blinkInterval = intervalMs;
+    _blinkFrames = framesFor(intervalMs);
+    _blinkCountdown = _blinkFrames;
+    _blinkMask = digitMask & allDigits();
+    _blinkHidden = 0;
+    _blinkEnabled = true;
+    wake();
+}
+
+// ========== setBlinkMask() ==========
+void SevenSegmentBase::setBlinkMask(uint8_t digitMask)
+{
+    digitMask &= allDigits();
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        _blinkMask = digitMask;
+        if (_blinkHidden)
+        {
+            _blinkHidden = digitMask;
+        }
+    }
+}
+
+// ========== stopBlink() ==========
+void SevenSegmentBase::stopBlink()
+{
+    _blinkEnabled = false;
+    _blinkHidden = 0;
+}
+#endif
+
+#if SSFD_MARQUEE
+// ========== scrollText() ==========
+SevenSegmentBase::Error SevenSegmentBase::scrollText(const char *text, uint16_t stepMs,
+                                                     ScrollMode mode, ScrollCallback done)
+{
+    return startScroll(text, false, stepMs, mode, done);
+}
+
+// ========== scrollText_P() ==========
+SevenSegmentBase::Error SevenSegmentBase::scrollText_P(PGM_P text, uint16_t stepMs,
+                                                       ScrollMode mode, ScrollCallback done)
+{
+    return startScroll(text, true, stepMs, mode, done);
+}
+
+// ========== startScroll() ==========
+SevenSegmentBase::Error SevenSegmentBase::startScroll(const char *text, bool progmem,
+                                                      uint16_t stepMs, ScrollMode mode,
+                                                      ScrollCallback done)
+{
+    if (text == nullptr)
+    {
+        return _lastError = Error::NULL_POINTER;
+    }
+    if (_selfRefreshing)
+    {
+        return _lastError = Error::NOT_SUPPORTED;
+    }
+
+    // Same lock-free handover as startBlink(): the ISR ignores the marquee
+    // state while no overlay mode is active
+    _overlayMode = OVERLAY_NONE;
+    compilerBarrier();
+
+    size_t length = progmem ? strlen_P(text) : strlen(text);
+    _scrollText = text;
+    _scrollProgmem = progmem;
+    _scrollMode = mode;
+    _scrollLength = length > 0x7FFF ? 0x7FFF : (uint16_t)length;
+    _scrollPos = 0;
+    _scrollStep = 1;
+    _scrollInterval = stepMs;
+    _scrollFrames = framesFor(stepMs);
+    _scrollCountdown = _scrollFrames;
+    _scrollDone = done;
+    renderScroll();
+
+    compilerBarrier();
+    _overlayMode = OVERLAY_SCROLL;
+    wake();
+    return _lastError = Error::OK;
+}
+
+// ========== stopScroll() ==========
+void SevenSegmentBase::stopScroll()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (_overlayMode == OVERLAY_SCROLL)
+        {
+            _overlayMode = OVERLAY_NONE;
+        }
+        if (_testResume == OVERLAY_SCROLL)
+        {
+            _testResume = OVERLAY_NONE;
+        }
+    }
+}
+
+// ========== stepScroll() ==========
+void SevenSegmentBase::stepScroll()
+{
+    if (--_scrollCountdown != 0)
+    {
+        return;
+    }
+    _scrollCountdown = _scrollFrames;
+
+    int16_t length = (int16_t)_scrollLength;
+    int16_t window = _numDigits;
+    switch (_scrollMode)
+    {
+    case ScrollMode::WRAP:
+        // Period is the text plus a full window of blanks
+        if (++_scrollPos >= length + window)
+        {
+            _scrollPos = 0;
+        }
+        break;
+
+    case ScrollMode::BOUNCE:
+        // Text that fits the window stays put
+        if (length <= window)
+        {
+            return;
+        }
+        _scrollPos += _scrollStep;
+        if (_scrollPos <= 0 || _scrollPos >= length - window)
+        {
+            _scrollStep = -_scrollStep;
+        }
+        break;
+
+    case ScrollMode::ONCE:
+        // Done once the last character has left digit 0
+        if (++_scrollPos >= length)
+        {
+            _overlayMode = OVERLAY_NONE;
+            if (_scrollDone != nullptr)
+            {
+                _scrollDone();
+            }
+            return;
+        }
+        break;
+    }
+
+    renderScroll();
+}
+
+// ========== renderScroll() ==========
+void SevenSegmentBase::renderScroll()
+{
+    int16_t length = (int16_t)_scrollLength;
+    int16_t window = _numDigits;
+    for (uint8_t i = 0; i < _numDigits; i++)
+    {
+        int16_t index = _scrollPos + i;
+        if (_scrollMode == ScrollMode::WRAP && index >= length + window)
+        {
+            index -= length + window;
+        }
+
+        char c = ' ';
+        if (index < length)
+        {
+            const char *p = _scrollText + index;
+            c = _scrollProgmem ? (char)pgm_read_byte(p) : *p;
+        }
+        _overlay[i] = getPattern(c);
+    }
+    _scanDirty = true;
+}
+#endif
+
+#if SSFD_ANIMATION
+// ========== playAnimation() ==========
+SevenSegmentBase::Error SevenSegmentBase::playAnimation(const uint8_t (*frames)[NUM_DIGITS],
+                                                        uint8_t frameCount, uint8_t fps,
+                                                        uint8_t loops)
+{
+    // Rows of NUM_DIGITS patterns only line up with a NUM_DIGITS display
+    if (frames != nullptr && _numDigits != NUM_DIGITS)
+    {
+        return _lastError = Error::INVALID_ARGUMENT;
+    }
+    return playAnimationFlat(reinterpret_cast<const uint8_t *>(frames), frameCount, fps, loops);
+}
+
+// ========== playAnimationFlat() ==========
+SevenSegmentBase::Error SevenSegmentBase::playAnimationFlat(const uint8_t *frames,
+                                                            uint8_t frameCount, uint8_t fps,
+                                                            uint8_t loops)
+{
+    Animation anim;
+    Error err = makeAnimation(anim, frames, frameCount, fps, loops);
+    if (err != Error::OK)
+    {
+        return _lastError = err;
+    }
+
+    // Lock-free handover: the ISR ignores the animation state while no
+    // overlay mode is active
+    _overlayMode = OVERLAY_NONE;
+    _animQueued = false;
+    compilerBarrier();
+    loadAnimation(anim);
+    compilerBarrier();
+    _overlayMode = OVERLAY_ANIMATION;
+    wake();
+    return _lastError = Error::OK;
+}
+
+// ========== queueAnimation() ==========
+SevenSegmentBase::Error SevenSegmentBase::queueAnimation(const uint8_t (*frames)[NUM_DIGITS],
+                                                         uint8_t frameCount, uint8_t fps,
+                                                         uint8_t loops)
+{
+    if (frames != nullptr && _numDigits != NUM_DIGITS)
+    {
+        return _lastError = Error::INVALID_ARGUMENT;
+    }
+    return queueAnimationFlat(reinterpret_cast<const uint8_t *>(frames), frameCount, fps, loops);
+}
+
+// ========== queueAnimationFlat() ==========
+SevenSegmentBase::Error SevenSegmentBase::queueAnimationFlat(const uint8_t *frames,
+                                                             uint8_t frameCount, uint8_t fps,
+                                                             uint8_t loops)
+{
+    Animation anim;
+    Error err = makeAnimation(anim, frames, frameCount, fps, loops);
+    if (err != Error::OK)
+    {
+        return _lastError = err;
+    }
+    if (_overlayMode != OVERLAY_ANIMATION)
+    {
+        return playAnimationFlat(frames, frameCount, fps, loops);
+    }
+
+    // The ISR only consumes the slot while _animQueued is set
+    _animQueued = false;
+    compilerBarrier();
+    _animNext = anim;
+    compilerBarrier();
+    _animQueued = true;
+
+    // Nothing to hand over to if the animation ended meanwhile
+    if (_overlayMode != OVERLAY_ANIMATION)
+    {
+        return playAnimationFlat(frames, frameCount, fps, loops);
+    }
+    return _lastError = Error::OK;
+}
+
+// ========== stopAnimation() ==========
+void SevenSegmentBase::stopAnimation()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        _animQueued = false;
+        if (_overlayMode == OVERLAY_ANIMATION)
+        {
+            _overlayMode = OVERLAY_NONE;
+        }
+        if (_testResume == OVERLAY_ANIMATION)
+        {
+            _testResume = OVERLAY_NONE;
+        }
+    }
+}
+
+// ========== makeAnimation() ==========
+SevenSegmentBase::Error SevenSegmentBase::makeAnimation(Animation &anim,
+                                                        const uint8_t *frames,
+                                                        uint8_t frameCount, uint8_t fps,
+                                                        uint8_t loops) const
+{
+    if (frames == nullptr)
+    {
+        return Error::NULL_POINTER;
+    }
+    if (frameCount == 0 || fps == 0)
+    {
+        return Error::INVALID_ARGUMENT;
+    }
+    if (_selfRefreshing)
+    {
+        return Error::NOT_SUPPORTED;
+    }
+
+    anim.frames = frames;
+    anim.frameCount = frameCount;
+    anim.fps = fps;
+    anim.loops = loops;
+    anim.stepFrames = animationFramesFor(fps);
+    return Error::OK;
+}
+
+// ========== animationFramesFor() ==========
+uint16_t SevenSegmentBase::animationFramesFor(uint8_t fps) const
+{
+    if (fps == 0)
+    {
+        return 1;
+    }
+    uint16_t frames = (_refreshHz + fps / 2) / fps;
+    return frames < 1 ? 1 : frames;
+}
+
+// ========== loadAnimation() ==========
+void SevenSegmentBase::loadAnimation(const Animation &anim)
+{
+    _anim = anim;
+    _animIndex = 0;
+    _animLoopsLeft = anim.loops;
+    _animCountdown = anim.stepFrames;
+    memcpy_P(_overlay, anim.frames, _numDigits);
+    _scanDirty = true;
+}
+
+// ========== stepAnimation() ==========
+void SevenSegmentBase::stepAnimation()
+{
+    if (--_animCountdown != 0)
+    {
+        return;
+    }
+    _animCountdown = _anim.stepFrames;
+
+    if (++_animIndex >= _anim.frameCount)
+    {
+        _animIndex = 0;
+
+        // End of a cycle: finished, or a looping-forever animation yields
+        // to the queue
+        bool finished = _anim.loops == 0 ? _animQueued : --_animLoopsLeft == 0;
+        if (finished)
+        {
+            if (_animQueued)
+            {
+                _animQueued = false;
+                loadAnimation(_animNext);
+                return;
+            }
+            _overlayMode = OVERLAY_NONE;
+            return;
+        }
+    }
+
+    memcpy_P(_overlay, _anim.frames + (uint16_t)_animIndex * _numDigits, _numDigits);
+    _scanDirty = true;
+}
+#endif
+
+#if SSFD_COUNTER
+// ========== startCounter() ==========
+SevenSegmentBase::Error SevenSegmentBase::startCounter(uint32_t start, uint16_t periodMs,
+                                                       CounterFormat format, int16_t step)
+{
+    if (_selfRefreshing)
+    {
+        return _lastError = Error::NOT_SUPPORTED;
+    }
+
+    bool minutes = format == CounterFormat::MM_SS;
+    uint8_t digits[MAX_DIGITS];
+    uint8_t stepDigits[MAX_DIGITS];
+    uint16_t magnitude = step < 0 ? (uint16_t)(-(int32_t)step) : (uint16_t)step;
+    if (periodMs == 0 || step == 0 || (minutes && _numDigits < 3) ||
+        !toCounterDigits(start, digits, minutes) ||
+        !toCounterDigits(magnitude, stepDigits, minutes))
+    {
+        return _lastError = Error::INVALID_ARGUMENT;
+    }
+
+    // Same lock-free handover as startScroll()
+    _overlayMode = OVERLAY_NONE;
+    compilerBarrier();
+
+    memcpy(_counterDigits, digits, _numDigits);
+    memcpy(_counterStep, stepDigits, _numDigits);
+    _counterStepTop = 0;
+    while (_counterStep[_counterStepTop] == 0)
+    {
+        _counterStepTop++;
+    }
+    _counterDown = step < 0;
+    _counterSixes = minutes ? _numDigits - 2 : 0xFF;
+    _counterColon = minutes ? _numDigits - 3 : 0xFF;
+    _counterPaused = false;
+    _counterInterval = periodMs;
+    _counterPeriod = (uint32_t)periodMs * _refreshHz;
+    _counterElapsed = 0;
+    renderCounter();
+
+    compilerBarrier();
+    _overlayMode = OVERLAY_COUNTER;
+    wake();
+    return _lastError = Error::OK;
+}
+
+// ========== pauseCounter() ==========
+void SevenSegmentBase::pauseCounter(bool paused)
+{
+    _counterPaused = paused;
+}
+
+// ========== stopCounter() ==========
+void SevenSegmentBase::stopCounter()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (_overlayMode == OVERLAY_COUNTER)
+        {
+            _overlayMode = OVERLAY_NONE;
+        }
+        if (_testResume == OVERLAY_COUNTER)
+        {
+            _testResume = OVERLAY_NONE;
+        }
+    }
+}
+
+// ========== getCounter() ==========
+uint32_t SevenSegmentBase::getCounter() const
+{
+    uint8_t digits[MAX_DIGITS];
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        memcpy(digits, _counterDigits, _numDigits);
+    }
+
+    // Mixed-radix Horner: minutes * 6 + tens of seconds, then * 10 + units
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < _numDigits; i++)
+    {
+        value = value * (i == _counterSixes ? 6 : 10) + digits[i];
+    }
+    return value;
+}
+
+// ========== toCounterDigits() ==========
+bool SevenSegmentBase::toCounterDigits(uint32_t value, uint8_t *digits, bool minutes) const
+{
+    // Seconds first for MM_SS; every other digit is decimal
+    uint8_t i = _numDigits;
+    if (minutes)
+    {
+        uint8_t seconds = (uint8_t)(value % 60);
+        value /= 60;
+        digits[--i] = seconds % 10;
+        digits[--i] = seconds / 10;
+    }
+    while (i > 0)
+    {
+        value = div10(value, digits[--i]);
+    }
+    return value == 0;
+}
+
+// ========== stepCounter() ==========
+void SevenSegmentBase::stepCounter()
+{
+    if (_counterPaused)
+    {
+        return;
+    }
+
+    // A frame lasts 1000 / hz ms, which is exactly 1000 in ms * hz units
+    _counterElapsed += 1000;
+    if (_counterElapsed < _counterPeriod)
+    {
+        return;
+    }
+    do
+    {
+        _counterElapsed -= _counterPeriod;
+        advanceCounter();
+    } while (_counterElapsed >= _counterPeriod);
+    renderCounter();
+}
+
+// ========== advanceCounter() ==========
+void SevenSegmentBase::advanceCounter()
+{
+    // Digit-wise add or subtract from the right. Stops once no carry is
+    // left and the step has no digits further left; the last carry out
+    // is dropped, so the count wraps
+    uint8_t carry = 0;
+    for (uint8_t i = _numDigits; i-- > 0;)
+    {
+        if (carry == 0 && i < _counterStepTop)
+        {
+            break;
+        }
+        uint8_t radix = i == _counterSixes ? 6 : 10;
+        uint8_t change = _counterStep[i] + carry;
+        uint8_t digit = _counterDigits[i];
+        if (_counterDown)
+        {
+            carry = digit < change;
+            digit = carry ? digit + radix - change : digit - change;
+        }
+        else
+        {
+            digit += change;
+            carry = digit >= radix;
+            if (carry)
+            {
+                digit -= radix;
+            }
+        }
+        _counterDigits[i] = digit;
+    }
+}
+
+// ========== renderCounter() ==========
+void SevenSegmentBase::renderCounter()
+{
+    // Leading zeros as in composeNumber(); MM_SS keeps the minutes' units
+    // digit and the seconds
+    bool isLeading = true;
+    for (uint8_t i = 0; i < _numDigits; i++)
+    {
+        uint8_t digit = _counterDigits[i];
+        uint8_t pattern = digitPattern(digit);
+        bool isUnits = i == _numDigits - 1 || i >= _counterColon;
+        if (!_leadingZeros && digit == 0 && isLeading && !isUnits)
+        {
+            pattern = PATTERN_BLANK;
+        }
+        else
+        {
+            isLeading = false;
+        }
+        if (i == _counterColon)
+        {
+            pattern |= PATTERN_DP;
+        }
+        _overlay[i] = pattern;
+    }
+    _scanDirty = true;
+}
+#endif
+
+// ========== SevenSegment (direct drive) ==========
+// Line levels that turn a segment / digit off (see SSFD_Config.h)
+static const uint8_t SEGMENT_OFF = SSFD_SEGMENTS_ACTIVE_LOW ? HIGH : LOW;
+static const uint8_t DIGIT_OFF = SSFD_DIGITS_ACTIVE_LOW ? HIGH : LOW;
+
+SevenSegment::SevenSegment(const uint8_t *segmentPins, const uint8_t *digitPins,
+                           uint8_t digitCount)
+    : SevenSegmentBase(digitCount),
+      _segmentPins(segmentPins),
+      _digitPins(digitPins)
+{
+    _segmentGroup.portCount = 0;
+    _digitGroup.portCount = 0;
+}
+
+// ========== VALIDATION HELPERS ==========
+bool SevenSegment::isPinValid(uint8_t pin)
+{
+    return pin <= MAX_PIN;
+}
+
+// ========== addPin() ==========
+bool SevenSegment::addPin(PinGroup &group, uint8_t bit, uint8_t pin, bool activeLow)
+{
+    ssfd::PortRef port;
+    ssfd::PortBits mask;
+    if (!ssfd::pinPort(pin, port, mask))
+    {
+        return false;
+    }
+
+    // Find or allocate the port slot for this pin
+    uint8_t slot = 0;
+    while (slot < group.portCount && group.ports[slot] != port)
+    {
+        slot++;
+    }
+    if (slot == group.portCount)
+    {
+        group.ports[slot] = port;
+        group.portMasks[slot] = 0;
+        group.portCount++;
+    }
+
+    group.portMasks[slot] |= mask;
+    group.portIndex[bit] = slot;
+    group.bitMasks[bit] = activeLow ? (ssfd::PortBits)~mask : mask;
+    return true;
+}
+
+// ========== writeGroup() ==========
+template <bool ActiveLow>
+SSFD_ISR_ATTR void SevenSegment::writeGroup(const PinGroup &group, uint8_t value)
+{
+    // Accumulate the pins to turn on per port: set bits (active-high) or
+    // clear bits through the inverted masks (active-low), same cost
+    ssfd::PortBits portBits[NUM_SEGMENTS];
+    memset(portBits, ActiveLow ? 0xFF : 0x00, sizeof(portBits));
+    for (uint8_t bit = 0; value != 0; bit++)
+    {
+        if (value & 0x01)
+        {
+            if (ActiveLow)
+            {
+                portBits[group.portIndex[bit]] &= group.bitMasks[bit];
+            }
+            else
+            {
+                portBits[group.portIndex[bit]] |= group.bitMasks[bit];
+            }
+        }
+        value >>= 1;
+    }
+
+    // One masked write per port
+    for (uint8_t p = 0; p < group.portCount; p++)
+    {
+        ssfd::PortBits mask = group.portMasks[p];
+        ssfd::writePort(group.ports[p], mask, ActiveLow ? portBits[p] & mask : portBits[p]);
+    }
+}
+
+// ========== beginOutput() ==========
+SevenSegment::Error SevenSegment::beginOutput()
+{
+    // Validate pointers
+    if (_segmentPins == nullptr || _digitPins == nullptr)
+    {
+        return Error::NULL_POINTER;
+    }
+
+    // Validate all pins before initializing
+    for (uint8_t i = 0; i < NUM_SEGMENTS; i++)
+    {
+        uint8_t pin = pgm_read_byte(&_segmentPins[i]);
+        if (!isPinValid(pin))
+        {
+            return Error::INVALID_PIN;
+        }
+    }
+
+    for (uint8_t i = 0; i < getDigitCount(); i++)
+    {
+        uint8_t pin = pgm_read_byte(&_digitPins[i]);
+        if (!isPinValid(pin))
+        {
+            return Error::INVALID_PIN;
+        }
+    }
+
+    // Cache port registers for the ISR (segment a = pattern bit 7)
+    _segmentGroup.portCount = 0;
+    _digitGroup.portCount = 0;
+    for (uint8_t i = 0; i < NUM_SEGMENTS; i++)
+    {
+        if (!addPin(_segmentGroup, 7 - i, pgm_read_byte(&_segmentPins[i]),
+                    SSFD_SEGMENTS_ACTIVE_LOW))
+        {
+            return Error::INVALID_PIN;
+        }
+    }
+
+    for (uint8_t i = 0; i < getDigitCount(); i++)
+    {
+        if (!addPin(_digitGroup, i, pgm_read_byte(&_digitPins[i]), SSFD_DIGITS_ACTIVE_LOW))
+        {
+            return Error::INVALID_PIN;
+        }
+    }
+
+    // Initialize segment pins (off level first, so no line lights briefly)
+    for (uint8_t i = 0; i < NUM_SEGMENTS; i++)
+    {
+        uint8_t pin = pgm_read_byte(&_segmentPins[i]);
+        digitalWrite(pin, SEGMENT_OFF);
+        pinMode(pin, OUTPUT);
+    }
+
+    // Initialize digit pins
+    for (uint8_t i = 0; i < getDigitCount(); i++)
+    {
+        uint8_t pin = pgm_read_byte(&_digitPins[i]);
+        digitalWrite(pin, DIGIT_OFF);
+        pinMode(pin, OUTPUT);
+    }
+
+    return Error::OK;
+}
+
+// ========== drive() ==========
+SSFD_ISR_ATTR void SevenSegment::drive(uint8_t segments, uint8_t digitMask)
+{
+    writeGroup<SSFD_DIGITS_ACTIVE_LOW>(_digitGroup, 0);
+    writeGroup<SSFD_SEGMENTS_ACTIVE_LOW>(_segmentGroup, segments);
+    writeGroup<SSFD_DIGITS_ACTIVE_LOW>(_digitGroup, digitMask);
+}
+
+// ========== SSFDTimer (display registry) ==========
+// ========== attach() ==========
+void SSFDTimer::attach(SevenSegmentBase *display)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        SevenSegmentBase *volatile *link = &_clients;
+        while (*link != nullptr && *link != display)
+        {
+            link = &(*link)->_nextClient;
+        }
+
+        // Append, so displays are scanned in the order they were begun
+        if (*link == nullptr)
+        {
+            display->_nextClient = nullptr;
+            *link = display;
+            retune();
+        }
+    }
+}
+
+// ========== detach() ==========
+void SSFDTimer::detach(SevenSegmentBase *display)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        SevenSegmentBase *volatile *link = &_clients;
+        while (*link != nullptr && *link != display)
+        {
+            link = &(*link)->_nextClient;
+        }
+
+        if (*link != nullptr)
+        {
+            *link = display->_nextClient;
+            display->_nextClient = nullptr;
+            if (_turn == display)
+            {
+                _turn = nullptr;
+                _turnEnded = false;
+            }
+            retune();
+        }
+    }
+}
+
+// ========== setSchedule() ==========
+void SSFDTimer::setSchedule(Schedule schedule)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        _schedule = schedule;
+        _turn = nullptr;
+        _turnEnded = false;
+        retune();
+    }
+
+    // The frame length changed; keep the attached displays' refresh rate
+    SevenSegmentBase *first = _clients;
+    if (first != nullptr)
+    {
+        setRate((uint32_t)first->_refreshHz * ticksPerFrame());
+    }
+}
+
+// ========== ticksPerFrame() ==========
+uint8_t SSFDTimer::ticksPerFrame() const
+{
+    uint8_t ticks = 0;
+    for (SevenSegmentBase *display = _clients; display != nullptr;
+         display = display->_nextClient)
+    {
+        uint8_t width = display->scanWidth();
+        if (_schedule == Schedule::ROUND_ROBIN)
+        {
+            ticks += width;
+        }
+        else if (width > ticks)
+        {
+            ticks = width;
+        }
+    }
+    return ticks;
+}
+
+// ========== retune() ==========
+void SSFDTimer::retune()
+{
+    // PARALLEL pads every scan to the widest display so all digits get the
+    // same duty; ROUND_ROBIN runs each display's own scan in turn
+    uint8_t widest = _schedule == Schedule::PARALLEL ? ticksPerFrame() : 0;
+    for (SevenSegmentBase *display = _clients; display != nullptr;
+         display = display->_nextClient)
+    {
+        display->_scanPeriod = widest != 0 ? widest : display->scanWidth();
+        display->_frameTicks = 0;
+        display->_scanDirty = true;
+    }
+}
+
+// ========== activeClients() ==========
+uint8_t SSFDTimer::activeClients() const
+{
+    uint8_t count = 0;
+    for (SevenSegmentBase *display = _clients; display != nullptr;
+         display = display->_nextClient)
+    {
+        if (display->_isrActive && !display->_timerGated)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+// ========== dispatchRoundRobin() ==========
+SSFD_ISR_ATTR void SSFDTimer::dispatchRoundRobin()
+{
+    SevenSegmentBase *display = _turn;
+    if (display == nullptr || _turnEnded)
+    {
+        // Next display that is running, after the current one (at most one
+        // lap; if none runs, multiplex() below does nothing)
+        SevenSegmentBase *next = display;
+        for (SevenSegmentBase *lap = _clients; lap != nullptr; lap = lap->_nextClient)
+        {
+            next = next != nullptr && next->_nextClient != nullptr ? next->_nextClient : _clients;
+            if (next->_isrActive && !next->_timerGated)
+            {
+                break;
+            }
+        }
+
+        // The segment lines are shared: switch the previous display off
+        // before the next one drives them
+        if (display != nullptr && next != display)
+        {
+            display->drive(0, 0);
+            display->flushOutput();
+        }
+        _turn = display = next;
+        _turnEnded = false;
+    }
+
+    if (display != nullptr && display->multiplex())
+    {
+        _turnEnded = true;
+    }
+}
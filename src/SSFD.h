@@ -2,7 +2,9 @@
 #define SSFD_H
 
 #include <Arduino.h>
-#include <avr/pgmspace.h>
+#include "SSFD_Config.h"
+#include "SSFD_Platform.h"
+#include "SSFD_Timer.h"
 
 /**
  * @file SSFD.h
@@ -11,13 +13,16 @@
  * @version 1.0.0
  * 
  * A robust, non-blocking library for controlling a common-cathode 7-segment
- * 4-digit display via multiplexing with Timer1 ISR. Supports integers, floats,
+ * 4-digit display via ISR multiplexing (Timer1 by default, see SSFD_Timer.h). Supports integers, floats,
  * text, and custom segments with full bounds checking and safety guards.
+ * Modules of 1..SSFD_MAX_DIGITS digits are supported, and several displays
+ * can share one timer.
  * 
  * **Requirements:**
  * - ATmega328P (Arduino Uno/Nano) or compatible
- * - 16 MHz clock frequency (Timer1 calibrated for this)
- * - Timer1 availability (not used by other code)
+ * - Any F_CPU (Timer1 prescaler and compare value derived from it)
+ * - One free timer (Timer1, Timer2 or Timer0 compare B), or an existing
+ *   periodic ISR that calls multiplex()
  * 
  * **Usage:**
  * ```cpp
@@ -31,19 +36,53 @@
  * }
  * 
  * void loop() {
- *   display.refresh(); // Non-blocking multiplexing
+ *   // Nothing to service: multiplexing and blinking run in the ISR
  * }
  * ```
  */
 
-class SevenSegment {
+#if SSFD_TEXT
+/**
+ * @brief 7-segment font in PROGMEM, indexed by character code
+ *
+ * Bit layout: 7=a, 6=b, 5=c, 4=d, 3=e, 2=f, 1=g, 0=dp. The built-in table
+ * is a weak definition; to use your own glyphs, define the table once in
+ * the sketch and it replaces the default at link time:
+ * ```cpp
+ * const uint8_t ssfdFont[SSFD_FONT_SIZE] PROGMEM = { ... };
+ * ```
+ */
+extern const uint8_t ssfdFont[SSFD_FONT_SIZE] PROGMEM;
+#endif
+
+/**
+ * @brief Output-independent display core shared by all SSFD drivers
+ *
+ * Holds the frame, the font and every formatting setter. Derived classes
+ * only provide pin setup and the drive() primitive that lights one set of
+ * digits with one segment pattern. Use SevenSegment (runtime PROGMEM pins)
+ * or SevenSegmentT (compile-time pins, see SSFD_Static.h).
+ *
+ * Also an Arduino Print sink: `display.print(value, HEX)` renders straight
+ * into the frame, with no heap and no intermediate buffer.
+ */
+class SevenSegmentBase : public Print {
 public:
   // ========== CONSTANTS ==========
-  static constexpr uint8_t NUM_DIGITS = 4;
+  static constexpr uint8_t NUM_DIGITS = 4;            // Default digit count
+  static constexpr uint8_t MAX_DIGITS = SSFD_MAX_DIGITS; // Largest supported count
   static constexpr uint8_t NUM_SEGMENTS = 8;
   static constexpr uint8_t MAX_PIN = 53;     // Arduino Uno max pin
   static constexpr uint16_t MAX_VALUE = 9999;
+#if SSFD_FLOAT
   static constexpr float MAX_FLOAT = 99.99f;
+#endif
+  static constexpr uint16_t MIN_REFRESH_HZ = 10;      // Full-frame rate limits
+  static constexpr uint16_t MAX_REFRESH_HZ = 2000;
+  static constexpr uint16_t DEFAULT_REFRESH_HZ = 125;
+  static constexpr uint8_t ALL_DIGITS = 0xFF;          // Mask of every digit, any count
+  static constexpr uint8_t MAX_BRIGHTNESS = 255;       // Full on-time (default)
+  static constexpr uint8_t MAX_DIGIT_LEVEL = 15;       // Per-digit full level (default)
 
   // Error codes
   enum class Error : uint8_t {
@@ -52,38 +91,130 @@ public:
     INVALID_PIN = 2,
     TIMER_INIT_FAILED = 3,
     NOT_INITIALIZED = 4,
-    INVALID_ARGUMENT = 5
+    INVALID_ARGUMENT = 5,
+    NOT_SUPPORTED = 6
   };
 
-  // ========== CONSTRUCTOR ==========
+#if SSFD_MARQUEE
   /**
-   * @brief Construct a SevenSegment display handler
-   * @param segmentPins PROGMEM array of 8 GPIO pins for segments (a-g, dp)
-   * @param digitPins PROGMEM array of 4 GPIO pins for digit control
-   * @warning Both arrays MUST be in PROGMEM and contain exactly the expected values
+   * @brief What the marquee does when the text reaches its end
    */
-  SevenSegment(const uint8_t* segmentPins, const uint8_t* digitPins);
+  enum class ScrollMode : uint8_t {
+    WRAP,   // Restart after NUM_DIGITS blanks, forever
+    BOUNCE, // Scroll back and forth between the two ends
+    ONCE    // Scroll the text out once, then call the done callback
+  };
+#endif
+
+  /**
+   * @brief Marquee / wiring test completion callback (runs in ISR context)
+   */
+  typedef void (*ScrollCallback)();
+
+#if SSFD_COUNTER
+  /**
+   * @brief How the self-running counter is laid out (see startCounter())
+   */
+  enum class CounterFormat : uint8_t {
+    DECIMAL, // Plain count, right-aligned like setNumber()
+    MM_SS    // Minutes and seconds; the DP after the minutes is the colon
+  };
+#endif
+
+  /**
+   * @brief Which digits the multiplex ISR scans (see setScanMode())
+   */
+  enum class ScanMode : uint8_t {
+    FULL,             // Every digit, every frame (default)
+    SKIP_BRIGHTER,    // Lit digits only, at the same tick rate
+    SKIP_FEWER_TICKS  // Lit digits at full-scan duty, blank ones in one long dark tick
+  };
+
+  /**
+   * @brief What one multiplex tick lights (see begin(SSFDTimer&, ScanOrder))
+   */
+  enum class ScanOrder : uint8_t {
+    DIGITS,  // One digit, all its segments (default)
+    SEGMENTS // One segment line, on every digit that uses it
+  };
+
+#if SSFD_STATS
+  /**
+   * @brief ISR timing snapshot (see getStats())
+   *
+   * All times are CPU cycles, measured with the backend's timer count, so
+   * they are multiples of `resolution` (the prescaler). Latency is read
+   * after the ISR prologue has saved its registers.
+   */
+  struct Stats {
+    uint32_t ticks;         // Timed multiplex() calls
+    uint16_t minCycles;     // Time spent in multiplex()
+    uint16_t maxCycles;
+    uint16_t meanCycles;
+    uint16_t minLatency;    // Compare match to ISR entry
+    uint16_t maxLatency;
+    uint16_t jitter;        // maxLatency - minLatency
+    uint16_t missedTicks;   // Next compare match already pending at ISR exit
+    uint16_t resolution;    // CPU cycles per timer count (1 = cycle-exact)
+    uint32_t updatesApplied; // Setter calls that published a new frame
+    uint32_t updatesSkipped; // Setter calls that changed nothing (repeat or same glyphs)
+  };
+#endif
 
   volatile bool _isrActive;
 
   // ========== CORE FUNCTIONS ==========
   /**
-   * @brief Initialize display pins and Timer1 ISR for multiplexing
+   * @brief Initialize display pins and the default timer ISR for multiplexing
    * @return Error code (Error::OK on success)
-   * @note MUST be called in setup(); display will not work without this
+   * @note MUST be called in setup(); display will not work without this.
+   *       The default timer is SSFD_DEFAULT_TIMER: ssfdTimer1 on ATmega328P,
+   *       ssfdTimerTCB0 on megaAVR-0, ssfdTimerRP2040, ssfdTimerESP32
+   */
+  Error begin() { return begin(SSFD_DEFAULT_TIMER); }
+
+  /**
+   * @brief Initialize on the default timer with a given scan order
+   */
+  Error begin(ScanOrder order) { return begin(SSFD_DEFAULT_TIMER, order); }
+
+  /**
+   * @brief Initialize display pins and multiplex from a given timer backend
+   * @param timer ssfdTimer1, ssfdTimer2, ssfdTimer0B, a backend of another
+   *        target (see SSFD_Timer.h) or ssfdExternalTick
+   * @param order DIGITS (default) lights one digit per tick. SEGMENTS
+   *        lights one segment line per tick, on every digit whose pattern
+   *        uses it, from the same frame buffer: NUM_SEGMENTS ticks per
+   *        frame, so each LED is lit 1/8 of the time instead of
+   *        1/getDigitCount(). A digit line then sinks one LED's current
+   *        whatever the digit shows, while a segment line sources up to
+   *        one LED per digit. Per-digit levels
+   *        (setDigitBrightness()) are not applied in this order
+   * @return Error::TIMER_INIT_FAILED if the backend cannot reach the rate;
+   *         Error::NOT_SUPPORTED for SEGMENTS on a self-refreshing output
+   *         (MAX7219)
+   * @note With ssfdExternalTick, call ssfdExternalTick.dispatch() from your
+   *       own periodic ISR at getRefreshRate() * ticksPerFrame() Hz.
+   *       Displays begun on the same backend share it (see
+   *       SSFDTimer::setSchedule()) and its refresh rate: this display's
+   *       rate is applied to all of them
    */
-  Error begin();
+  Error begin(SSFDTimer& timer, ScanOrder order = ScanOrder::DIGITS);
 
   /**
-   * @brief Disable Timer1 and perform cleanup
-   * @note Call before reinitializing or if Timer1 is needed elsewhere
+   * @brief Get the scan order set by the last begin()
+   */
+  ScanOrder getScanOrder() const { return _scanOrder; }
+
+  /**
+   * @brief Stop the timer backend and perform cleanup
+   * @note Call before reinitializing or if the timer is needed elsewhere
    */
   void end();
 
   /**
-   * @brief Refresh the display (non-blocking multiplexing step)
-   * @note Must be called frequently in loop() for stable display
-   * @warning If called from ISR context, this is a no-op
+   * @brief Refresh the display (kept for compatibility)
+   * @note No longer required: multiplexing and blinking both run in the ISR
    */
   void refresh();
 
@@ -95,10 +226,37 @@ public:
   /**
    * @brief Test wiring and detect faults (BLOCKING)
    * @param delayMs Duration (ms) to illuminate each segment
-   * @note Call only in setup(); blocks execution
+   * @note Call only in setup(); blocks for 8 x delayMs. See
+   *       startWiringTest() for a version that runs from the ISR
    */
   void testWiring(unsigned int delayMs = 500);
 
+  /**
+   * @brief Walk the wiring test from the multiplex ISR (non-blocking)
+   * @param stepMs Time per step in milliseconds
+   * @param done Called from the ISR when the last step ends (may be nullptr)
+   * @return Error::NOT_SUPPORTED on self-refreshing outputs (MAX7219); use
+   *         testWiring() there
+   * @note Lights each segment (a-g, then dp) on every digit, then each digit
+   *       with all segments, so a stuck segment line and a stuck digit line
+   *       are told apart. Returns at once; setup() and the watchdog carry on.
+   *       Setters stage the static frame meanwhile. When done, a marquee,
+   *       animation or counter that was running resumes where it was (held
+   *       during the test), otherwise the static frame is shown. Blink does
+   *       not hide test steps
+   */
+  Error startWiringTest(uint16_t stepMs = 500, ScrollCallback done = nullptr);
+
+  /**
+   * @brief End the wiring test early (the done callback is not called)
+   */
+  void stopWiringTest();
+
+  /**
+   * @brief Check if startWiringTest() is still running
+   */
+  bool isTestingWiring() const { return _overlayMode == OVERLAY_WIRING; }
+
   /**
    * @brief Check if display is properly initialized
    * @return true if begin() succeeded
@@ -111,44 +269,175 @@ public:
    */
   Error getLastError() const { return _lastError; }
 
+  /**
+   * @brief Number of digits given to the constructor
+   * @return 1..MAX_DIGITS, or 0 if the constructor count was out of range
+   *         (begin() then fails with Error::INVALID_ARGUMENT)
+   */
+  uint8_t getDigitCount() const { return _numDigits; }
+
   // ========== DISPLAY DATA FUNCTIONS ==========
   /**
-   * @brief Display a 4-digit unsigned integer
-   * @param value 0..9999 (values > 9999 clamped)
-   * @param dpPosition Position of decimal point: -1 (none), 0..3 (after digit N)
-   * @note dpPosition=1 displays as "XXX.X" (decimal after 2nd digit from left)
+   * @brief Display an unsigned integer, right-aligned
+   * @param value 0..9999 on 4 digits (clamped to the largest value that fits)
+   * @param dpPosition Position of decimal point: -1 (none), 0..digits-1 (after digit N)
+   * @note dpPosition=1 displays as "XX.XX" (decimal after 2nd digit from left)
    */
   void setNumber(uint16_t value, int8_t dpPosition = -1);
 
+#if SSFD_FLOAT
   /**
    * @brief Display a floating-point number with auto-decimal placement
-   * @param value 0.00..99.99 (clamped and rounded)
+   * @param value -99.9..9999 on 4 digits (clamped and rounded; the range
+   *        grows with the digit count)
    * @return Error code if NaN/Inf detected
-   * @note Decimal point position chosen based on magnitude (e.g., 1.23 vs 12.34)
+   * @note Decimal point position chosen based on magnitude (e.g., 1.23 vs 12.34).
+   *       Uses one float multiply and a PROGMEM power-of-ten table; no libm
    */
   Error setFloat(float value);
+#endif
+
+  /**
+   * @brief Display a fixed-point value (mantissa * 10^exponent) without floats
+   * @param mantissa Signed integer digits, e.g. 1234
+   * @param exponent Power of ten, e.g. -2 for hundredths (1234 -> "12.34")
+   * @return Error::INVALID_ARGUMENT if the integer part does not fit
+   *         (display saturates to "9999" / "-999")
+   * @note Same decimal-point and sign layout as setFloat(); decimals that do
+   *       not fit are dropped with round-half-up
+   */
+  Error setFixed(int32_t mantissa, int8_t exponent);
+
+  /**
+   * @brief Display a signed integer (-999..9999 on 4 digits)
+   * @return Error::INVALID_ARGUMENT if the value does not fit (display
+   *         saturates to "9999" / "-999")
+   * @note Integer digit split only; same sign layout as setFixed(value, 0)
+   */
+  Error setInt(int16_t value);
+
+  /**
+   * @brief Display a value as four hex digits (0000..FFFF), always zero padded
+   * @return Error::INVALID_ARGUMENT if it needs more nibbles than the display
+   *         has digits (display saturates to all F)
+   * @note One nibble-indexed PROGMEM lookup per digit: no division, about
+   *       the cost of setSegments(). Wider displays are padded with blanks
+   *       on the left
+   */
+  Error setHex(uint16_t value);
 
+#if SSFD_TEXT
   /**
-   * @brief Display text (up to 4 ASCII characters)
-   * @param text String to display; strlen must be <= 4
+   * @brief Display text (up to getDigitCount() ASCII characters)
+   * @param text String to display; strlen must be <= getDigitCount()
    * @return Error code if text invalid
-   * @note Supported: digits 0-9, A-Z (uppercase), space, dash, equals
+   * @note Each character is one lookup in the ASCII font (ssfdFont):
+   *       digits, A-Z, distinct lowercase forms (b, c, d, h, o, u ...) and
+   *       punctuation such as - _ = ' " ? and SSFD_CHAR_DEGREE.
+   *       Characters without a glyph are shown blank
    */
   Error setText(const char* text);
+#endif
 
   /**
    * @brief Display raw 7-segment patterns (advanced)
-   * @param patterns Array of 4 bytes; bit 7=a, 6=b, ..., 0=dp
+   * @param patterns Array of getDigitCount() bytes; bit 7=a, 6=b, ..., 0=dp
    */
   void setSegments(const uint8_t patterns[NUM_DIGITS]);
 
   /**
    * @brief Set integer value using hundredths (avoids float math)
    * @param hundredths Value in hundredths: 0..9999 = 0.00..99.99
-   * @param dpPosition Decimal point position (-1..3)
+   * @param dpPosition Digit the decimal point follows, as in setNumber()
+   *        (-1 = none, 0..digits-1)
+   * @note On four digits dpPosition 1 shows hundredths: setHundredths(1234, 1)
+   *       is "12.34". The default 2 shows "123.4"
    */
   void setHundredths(uint16_t hundredths, int8_t dpPosition = 2);
 
+  // ========== FRAME BUILDER ==========
+  /**
+   * @brief Open a staged frame; nothing is shown until commit()
+   * @param clear true = start blank; false = start from the latest frame
+   *        (a published frame the ISR has not picked up yet counts)
+   * @note While the frame is open, the setters above and the put*() calls
+   *       all write into it without publishing, so a composed screen such
+   *       as a value plus a unit letter is one publish, never shown half
+   *       done. Calling beginFrame() again restarts the open frame
+   */
+  void beginFrame(bool clear = true);
+
+#if SSFD_TEXT
+  /**
+   * @brief Set one digit to a character glyph (replaces its DP)
+   * @param digit 0..getDigitCount()-1, left to right
+   * @return Error::INVALID_ARGUMENT if digit is out of range
+   * @note Outside beginFrame()/commit() the digit is patched and published
+   *       on its own, keeping the other digits
+   */
+  Error putChar(uint8_t digit, char c);
+#endif
+
+  /**
+   * @brief Set one digit to a numeral (replaces its DP)
+   * @param value 0..15 (10..15 shown as A..F)
+   * @return Error::INVALID_ARGUMENT if digit or value is out of range
+   */
+  Error putDigit(uint8_t digit, uint8_t value);
+
+  /**
+   * @brief Light or clear the decimal point of one digit, keeping its glyph
+   */
+  Error putDP(uint8_t digit, bool on = true);
+
+  /**
+   * @brief Set one digit to a raw pattern (bit 7=a, ..., 0=dp)
+   */
+  Error putRaw(uint8_t digit, uint8_t pattern);
+
+  /**
+   * @brief Publish the open frame (one frame swap, at the next scan boundary)
+   * @note Nothing is published when the glyphs match the frame on show, or
+   *       when no frame is open
+   */
+  void commit();
+
+  /**
+   * @brief Check if a frame opened by beginFrame() is waiting for commit()
+   */
+  bool isFrameOpen() const { return _frameOpen; }
+
+  // ========== PRINT STREAM ==========
+  using Print::write;
+
+  /**
+   * @brief Print sink: render one character at the cursor
+   * @return 1 if the character was taken, 0 past the last digit
+   * @note Outside beginFrame()/commit() every print() call publishes once.
+   *       '.' lights the DP of the previous digit instead of taking a cell.
+   *       '\n' ends the line: the next character starts a blank frame at
+   *       digit 0 (so `println()` in a loop rewrites the screen); '\r' is
+   *       ignored. clear() and beginFrame() also rewind the cursor
+   */
+  size_t write(uint8_t c) override;
+
+  /**
+   * @brief Print sink for a run of characters (one publish for the run)
+   */
+  size_t write(const uint8_t* buffer, size_t size) override;
+
+  /**
+   * @brief Move the print cursor, keeping the frame (e.g. to print a unit)
+   * @param digit 0..getDigitCount()-1
+   * @return Error::INVALID_ARGUMENT if digit is out of range
+   */
+  Error setCursor(uint8_t digit);
+
+  /**
+   * @brief Digit the next printed character goes to
+   */
+  uint8_t getCursor() const { return _cursor; }
+
   // ========== DISPLAY MODES ==========
   /**
    * @brief Enable/disable leading zero suppression
@@ -156,19 +445,166 @@ public:
    */
   void setLeadingZeros(bool enabled);
 
+  /**
+   * @brief Set the full-frame refresh rate (all digits scanned once)
+   * @param hz MIN_REFRESH_HZ..MAX_REFRESH_HZ (default DEFAULT_REFRESH_HZ)
+   * @return Error::INVALID_ARGUMENT if the rate is out of range
+   * @note The timer is programmed from F_CPU. If the display is running the
+   *       timer is retuned in place (no stop, no run-out to 0xFFFF).
+   *       Lower = less ISR load; higher = less flicker on camera. Every
+   *       display on the same timer is retuned to the new rate
+   */
+  Error setRefreshRate(uint16_t hz);
+
+  /**
+   * @brief Get the configured full-frame refresh rate
+   * @return Frame rate in Hz
+   */
+  uint16_t getRefreshRate() const { return _refreshHz; }
+
   /**
    * @brief Set refresh interval (multiplexing speed)
-   * @param ms Interval 1..255 (milliseconds between digit cycles)
+   * @param ms Frame period 1..100 ms (converted to setRefreshRate(1000 / ms))
    * @note Lower = faster refresh, brighter; higher = dimmer but less ISR load
+   * @deprecated Use setRefreshRate()
    */
   void setRefreshInterval(uint8_t ms);
 
+  /**
+   * @brief Choose how blank digits are scanned
+   * @param mode FULL (default), SKIP_BRIGHTER or SKIP_FEWER_TICKS
+   * @note The ISR rebuilds its list of lit digits when the shown frame
+   *       changes; lit digits are always equally bright.
+   *       SKIP_BRIGHTER cycles through the lit digits only, so "   5" gets
+   *       every tick (4x brighter, same ISR load). SKIP_FEWER_TICKS keeps
+   *       the on-time of FULL and stretches one dark tick over the blank
+   *       digits, so "   5" costs 2 interrupts per frame instead of 4
+   *       (as far as the compare register reaches: 3 on Timer1 at 125 Hz;
+   *       one more on SevenSegment595, which shows each digit a tick late).
+   *       ssfdExternalTick cannot stretch, so it keeps the tick rate and
+   *       only skips drive(); neither can a timer shared by several displays.
+   *       On a ROUND_ROBIN timer SKIP_BRIGHTER keeps the full scan length.
+   *       Blink, scroll and animation timing are unchanged
+   */
+  void setScanMode(ScanMode mode);
+
+  /**
+   * @brief Get the scan mode set by setScanMode()
+   */
+  ScanMode getScanMode() const { return _scanMode; }
+
+  // ========== BRIGHTNESS ==========
+  /**
+   * @brief Dim the display by blanking each digit partway through its tick
+   * @param level 0..MAX_BRIGHTNESS: lit share of every digit's tick in
+   *        1/256 steps (MAX_BRIGHTNESS = whole tick, the default)
+   * @return Error::NOT_SUPPORTED if the timer has no second compare channel
+   *         (ssfdTimer0B, ssfdExternalTick)
+   * @note Hardware timed: ssfdTimer1 and ssfdTimer2 blank from a compare-B
+   *       interrupt (OCR1B / OCR2B), one short extra interrupt per tick and
+   *       none at MAX_BRIGHTNESS. The MAX7219 maps the level to its
+   *       16-step intensity register. Before begin() the level is stored
+   *       and applied when the timer starts. Displays on one timer share
+   *       its brightness. Ends a fade
+   */
+  Error setBrightness(uint8_t level);
+
+  /**
+   * @brief Get the brightness set by setBrightness() or reached by a fade
+   */
+  uint8_t getBrightness() const { return _brightness; }
+
+  /**
+   * @brief Fade smoothly to a brightness, stepped once per frame by the ISR
+   * @param level Target 0..MAX_BRIGHTNESS
+   * @param durationMs Fade time (0 = jump, like setBrightness())
+   * @return Error::NOT_SUPPORTED where setBrightness() is, or on a
+   *         self-refreshing output (no ISR to step it)
+   * @note The main loop only sets the fade up; each frame the ISR adds a
+   *       fixed-point step and retunes the compare channel when the level
+   *       changes. Idle refresh waits until the fade is done
+   */
+  Error fadeTo(uint8_t level, uint16_t durationMs);
+
+  /**
+   * @brief Check if a fade started by fadeTo() is still running
+   */
+  bool isFading() const { return _fadeFrames != 0; }
+
+  /**
+   * @brief Dim one digit relative to the others
+   * @param digit 0 = leftmost
+   * @param level 0 (dark) .. MAX_DIGIT_LEVEL (as bright as the display,
+   *        the default), scaled by the display brightness
+   * @return Error::INVALID_ARGUMENT for a digit or level out of range;
+   *         Error::NOT_SUPPORTED where setBrightness() is, or on a
+   *         self-refreshing output (one intensity for all digits)
+   * @note Only one digit is lit per tick, so its level becomes the
+   *       compare-B point of its own tick: one register write per tick and
+   *       still one blanking interrupt, however many levels are used. Needs
+   *       the timer to itself or Schedule::ROUND_ROBIN; on a PARALLEL timer
+   *       shared with other displays, or in ScanOrder::SEGMENTS (several
+   *       digits per tick), the digits keep the display brightness
+   */
+  Error setDigitBrightness(uint8_t digit, uint8_t level);
+
+  /**
+   * @brief Get a digit's level set by setDigitBrightness()
+   * @return 0..MAX_DIGIT_LEVEL, or 0 for a digit out of range
+   */
+  uint8_t getDigitBrightness(uint8_t digit) const {
+    return digit < _numDigits ? _digitLevel[digit] : 0;
+  }
+
+  // ========== POWER MANAGEMENT ==========
+  /**
+   * @brief Stop the timer while the display is blank
+   * @param enabled true = an all-blank static frame (e.g. after clear())
+   *        switches the digits off and stops the timer at the next frame
+   *        boundary; the next setter, startBlink(), marquee, animation or
+   *        counter restarts it
+   * @note No effect on self-refreshing outputs (MAX7219). On a shared timer
+   *       the display only goes dark; the timer stops once every display
+   *       on it is blank-stopped
+   */
+  void setBlankStop(bool enabled);
+
+  /**
+   * @brief Drop to a lower refresh rate when the display stops changing
+   * @param afterSeconds Seconds without a new frame before dropping (0 = off)
+   * @param idleHz Refresh rate while idle (MIN_REFRESH_HZ..MAX_REFRESH_HZ)
+   * @return Error::INVALID_ARGUMENT if idleHz is out of range
+   * @note Only counts while no blink, marquee, animation or counter runs. The next
+   *       published frame restores getRefreshRate(). The ISR retunes the
+   *       timer once on entering idle (about 100 us on Timer1). Suspended
+   *       while other displays share the timer
+   */
+  Error setIdleRefresh(uint16_t afterSeconds, uint16_t idleHz = MIN_REFRESH_HZ);
+
+  /**
+   * @brief Display interrupts per second right now
+   * @return 0 while the timer is stopped (end(), setBlankStop()),
+   *         idleHz * ticksPerFrame() while idle, otherwise
+   *         getRefreshRate() * ticksPerFrame() (see SSFDTimer)
+   * @note Upper bound on the display's wake-ups from SLEEP_MODE_IDLE
+   *       (ScanMode::SKIP_FEWER_TICKS needs fewer)
+   */
+  uint32_t getTickRate() const;
+
+#if SSFD_BLINK
   /**
    * @brief Start blinking the display
-   * @param intervalMs Blink period in milliseconds (typically 500)
-   * @note Calls blinkEnable(true) automatically
+   * @param intervalMs Time each on/off phase lasts in milliseconds (typically 500)
+   * @param digitMask Digits that blink (bit N = digit N); others stay lit
+   * @note Timed in the ISR from the frame rate; loop() needs no servicing
+   */
+  void startBlink(unsigned long intervalMs = 500, uint8_t digitMask = ALL_DIGITS);
+
+  /**
+   * @brief Change which digits blink without restarting the blink phase
+   * @param digitMask Bit N = digit N (e.g. 0b0011 flashes the two left digits)
    */
-  void startBlink(unsigned long intervalMs = 500);
+  void setBlinkMask(uint8_t digitMask);
 
   /**
    * @brief Stop blinking the display
@@ -180,42 +616,683 @@ public:
    * @return true if blinking
    */
   bool isBlinking() const { return _blinkEnabled; }
+#endif
+
+#if SSFD_MARQUEE
+  /**
+   * @brief Scroll a RAM string of any length across the display
+   * @param text Null-terminated string; NOT copied, must stay valid and
+   *        unchanged until the marquee stops
+   * @param stepMs Time per one-character step in milliseconds
+   * @param mode WRAP, BOUNCE or ONCE
+   * @param done Called from the ISR when a ONCE marquee finishes (may be nullptr)
+   * @return Error::NULL_POINTER, or Error::NOT_SUPPORTED on self-refreshing
+   *         outputs (MAX7219), which have no multiplex ISR
+   * @note The ISR advances and renders the text; loop() needs no servicing.
+   *       While scrolling, setNumber()/setText()/... stage the frame that is
+   *       shown once the marquee stops
+   */
+  Error scrollText(const char* text, uint16_t stepMs = 300,
+                   ScrollMode mode = ScrollMode::WRAP, ScrollCallback done = nullptr);
+
+  /**
+   * @brief Scroll a PROGMEM string (same rules as scrollText())
+   */
+  Error scrollText_P(PGM_P text, uint16_t stepMs = 300,
+                     ScrollMode mode = ScrollMode::WRAP, ScrollCallback done = nullptr);
+
+  /**
+   * @brief Scroll an F("...") string (same rules as scrollText())
+   */
+  Error scrollText(const __FlashStringHelper* text, uint16_t stepMs = 300,
+                   ScrollMode mode = ScrollMode::WRAP, ScrollCallback done = nullptr) {
+    return scrollText_P(reinterpret_cast<PGM_P>(text), stepMs, mode, done);
+  }
+
+  /**
+   * @brief Stop the marquee and show the staged static frame again
+   * @note The done callback is not called
+   */
+  void stopScroll();
+
+  /**
+   * @brief Check if a marquee is running
+   */
+  bool isScrolling() const { return _overlayMode == OVERLAY_SCROLL; }
+#endif
+
+#if SSFD_ANIMATION
+  /**
+   * @brief Play a PROGMEM animation from the multiplex ISR
+   * @param frames PROGMEM array of frames, NUM_DIGITS patterns each
+   *        (`const uint8_t anim[][4] PROGMEM`); not copied. Only for
+   *        4-digit displays; others use playAnimationFlat()
+   * @param frameCount Number of frames (1..255)
+   * @param fps Animation frames per second (1..255, quantized to whole refresh frames)
+   * @param loops Times to play the sequence (0 = forever)
+   * @return Error::NULL_POINTER, Error::INVALID_ARGUMENT for a zero count or
+   *         rate, or Error::NOT_SUPPORTED on self-refreshing outputs
+   * @note Replaces a running marquee or animation and drops any queued one.
+   *       When it ends, the queued animation starts at the next frame;
+   *       otherwise the staged static frame (last setter call) is shown
+   */
+  Error playAnimation(const uint8_t (*frames)[NUM_DIGITS], uint8_t frameCount,
+                      uint8_t fps, uint8_t loops = 0);
+
+  /**
+   * @brief Play a PROGMEM animation of getDigitCount() patterns per frame
+   * @param frames Flat PROGMEM array, frameCount * getDigitCount() bytes
+   * @note Same rules as playAnimation(), for any digit count
+   */
+  Error playAnimationFlat(const uint8_t* frames, uint8_t frameCount, uint8_t fps,
+                          uint8_t loops = 0);
+
+  /**
+   * @brief Queue an animation to start when the current one ends
+   * @note A looping-forever animation hands over at the end of its current
+   *       cycle. Starts immediately if no animation is playing. One slot:
+   *       a second call replaces the queued animation
+   */
+  Error queueAnimation(const uint8_t (*frames)[NUM_DIGITS], uint8_t frameCount,
+                       uint8_t fps, uint8_t loops = 1);
+
+  /**
+   * @brief Queue a flat-array animation (see playAnimationFlat())
+   */
+  Error queueAnimationFlat(const uint8_t* frames, uint8_t frameCount, uint8_t fps,
+                           uint8_t loops = 1);
+
+  /**
+   * @brief Stop the animation, drop the queue and show the static frame
+   */
+  void stopAnimation();
+
+  /**
+   * @brief Check if an animation is playing
+   */
+  bool isAnimating() const { return _overlayMode == OVERLAY_ANIMATION; }
+#endif
+
+#if SSFD_COUNTER
+  /**
+   * @brief Count from the multiplex ISR: the display advances by step
+   *        every periodMs with no main-loop work
+   * @param start First value shown. DECIMAL: 0..10^digits-1; MM_SS: in
+   *        seconds (counts), 0..(10^(digits-2))*60-1, e.g. 5999 = "99:59"
+   * @param periodMs Time per step in milliseconds (1..65535)
+   * @param format DECIMAL or MM_SS (MM_SS needs 3 or more digits)
+   * @param step Counts added per period (negative counts down); the same
+   *        range as start
+   * @return Error::INVALID_ARGUMENT for a value out of range, a zero step
+   *         or period, or Error::NOT_SUPPORTED on self-refreshing outputs
+   * @note The count is kept as one decimal digit per display digit and
+   *       stepped with carry propagation, so the ISR never divides. Time
+   *       is accumulated per frame in ms * Hz with no rounding drift, so
+   *       the count is as exact as the timer (periods shorter than a frame
+   *       advance several steps per frame). It wraps like an odometer at
+   *       either end. Replaces a running marquee or animation; setters
+   *       stage the frame shown after stopCounter()
+   */
+  Error startCounter(uint32_t start, uint16_t periodMs,
+                     CounterFormat format = CounterFormat::DECIMAL, int16_t step = 1);
+
+  /**
+   * @brief Hold (true) or continue (false) the count on show
+   * @note The partial period is kept, as on a stopwatch
+   */
+  void pauseCounter(bool paused = true);
+
+  /**
+   * @brief Stop the counter and show the staged static frame again
+   */
+  void stopCounter();
+
+  /**
+   * @brief Check if the counter is shown (running or paused)
+   */
+  bool isCounting() const { return _overlayMode == OVERLAY_COUNTER; }
+
+  /**
+   * @brief Current count (MM_SS: in seconds), the value of the last
+   *        counter if it has stopped
+   */
+  uint32_t getCounter() const;
+#endif
+
+#if SSFD_STATS
+  /**
+   * @brief Copy the ISR timing statistics
+   * @note Only with SSFD_STATS=1; nothing is recorded for ssfdExternalTick
+   */
+  Stats getStats() const;
+
+  /**
+   * @brief Start a new measurement window
+   */
+  void resetStats();
+#endif
 
-   /**
+  /**
    * @brief Perform one multiplexing cycle (called by ISR or refresh())
+   * @return true if this tick drove the last slot of a scan (or nothing)
+   * @note No-op before begin() succeeds. With several displays on one
+   *       timer, call SSFDTimer::dispatch() instead
    */
-  void multiplex();
+  bool multiplex();
+
+  // ========== OUTPUT INTERFACE ==========
+protected:
+  /**
+   * @param digitCount Digits on the module (1..MAX_DIGITS); digit 0 is the
+   *        leftmost and the units digit is the last one
+   */
+  explicit SevenSegmentBase(uint8_t digitCount = NUM_DIGITS);
+
+  /**
+   * @brief Detach from a timer that is still running the display
+   */
+  ~SevenSegmentBase();
+
+  /**
+   * @brief Validate and configure the output pins (called by begin())
+   * @return Error::OK, or the reason the pins cannot be driven
+   */
+  virtual Error beginOutput() = 0;
+
+  /**
+   * @brief Light the digits in digitMask with one segment pattern
+   * @param segments Pattern; bit 7=a, 6=b, ..., 0=dp
+   * @param digitMask Bit N set = digit N enabled (0 = all digits off);
+   *        bits above getDigitCount() are never set
+   * @note Called from the ISR; must switch digits off before changing
+   *       segments to avoid ghosting
+   */
+  virtual void drive(uint8_t segments, uint8_t digitMask) = 0;
+
+  /**
+   * @brief Make the last drive() visible now (main or ISR context)
+   * @note For outputs that defer the update to the next tick (shift registers)
+   */
+  virtual void flushOutput() {}
+
+  /**
+   * @brief Called when a frame is published on a self-refreshing output
+   * @param frame Patterns now shown
+   * @param previous Patterns shown before, or nullptr to push every digit
+   */
+  virtual void frameUpdated(const uint8_t* frame, const uint8_t* previous) {
+    (void)frame;
+    (void)previous;
+  }
+
+  /**
+   * @brief Switch off the digit lit by this tick, mid-tick (dimming ISR)
+   * @note Outputs that queue the next digit (shift registers) must keep it
+   *       queued
+   */
+  virtual void blankOutput() {
+    drive(0, 0);
+    flushOutput();
+  }
+
+  /**
+   * @brief Set the brightness of a self-refreshing output
+   * @param level 0..MAX_BRIGHTNESS
+   * @return false if the output has no brightness control
+   */
+  virtual bool outputBrightness(uint8_t level) {
+    (void)level;
+    return false;
+  }
+
+  /**
+   * Set by outputs that refresh the digits themselves (e.g. MAX7219). No
+   * timer is started and frames go to frameUpdated() as they are published.
+   */
+  bool _selfRefreshing;
+
+  /**
+   * Set by outputs whose drive() only shows at the next tick (e.g.
+   * 74HC595). The first dark slot after a lit digit then keeps its base
+   * period, in which that digit is shown; the dark stretch starts after it.
+   */
+  bool _deferredOutput;
 
   // ========== PRIVATE MEMBERS ==========
 private:
-  // Pin arrays (stored as PROGMEM pointers)
-  const uint8_t* _segmentPins;
-  const uint8_t* _digitPins;
+  friend class SSFDTimer;
+
+  const uint8_t _numDigits;         // 0 = invalid constructor count
 
-  // Display state
-  volatile uint8_t _displayPatterns[NUM_DIGITS];
+  // Display state (double-buffered; the ISR reads _frames[_frontFrame])
+  uint8_t _frames[2][MAX_DIGITS];
+  volatile uint8_t _frontFrame;
+  volatile bool _framePending; // Back buffer published, swap at digit 0
+  bool _frameOpen;              // beginFrame() staging, publish deferred to commit()
+  uint8_t _cursor;              // Print stream: next digit written
+  bool _lineEnded;              // Print stream: next character starts a blank frame
   bool _leadingZeros;
 
-  // Multiplexing
-  volatile uint8_t _currentDigit;
-  uint8_t _refreshIntervalMs;
-  unsigned long _lastRefreshTime;
+  // Multiplexing: the ISR walks _scanList, rebuilt from the shown frame
+  // whenever it changes
+  static constexpr uint8_t SCAN_DARK = 0xFF; // Slot with all digits off
+  volatile ScanMode _scanMode;
+  ScanOrder _scanOrder;
+  volatile bool _scanDirty;         // Rebuild _scanList at the next boundary
+  uint8_t _scanList[NUM_SEGMENTS];  // Digit or segment index (or SCAN_DARK) per slot
+  uint8_t _segmentDigits[NUM_SEGMENTS]; // ScanOrder::SEGMENTS: digits lit per segment line
+  uint8_t _scanSlots;               // Slots per scan
+  uint8_t _scanPeriod;              // Ticks per frame, set by the timer
+  volatile uint8_t _scanSlot;       // Slot driven by the last tick
+  uint8_t _frameTicks;              // Base ticks towards the next frame step
+  bool _scanStretched;              // Current timer period is stretched
+  bool _scanDarkDriven;             // Digits already switched off by a dark slot
+  uint8_t _scanLit;                 // Non-blank digits (or used segments) in _scanSource
+  const uint8_t* _scanSource;       // Frame or overlay being scanned
+  uint16_t _refreshHz;
+  SSFDTimer* _timer; // Backend from begin(), nullptr when stopped
+  SevenSegmentBase* _nextClient;    // Next display on the same timer
+
+#if SSFD_BLINK
+  // Blinking (phase counted in frames by the ISR)
+  volatile bool _blinkEnabled;
+  volatile uint8_t _blinkMask;      // Digits that blink
+  volatile uint8_t _blinkHidden;    // Digits blanked in the current phase
+  volatile uint16_t _blinkFrames;   // Frames per phase
+  volatile uint16_t _blinkCountdown;
+  unsigned long _blinkInterval;     // Phase length in ms (rescaled on rate change)
+#endif
+
+  // ISR display modes render into _overlay, which replaces the static
+  // frame while the mode runs. One mode at a time.
+  enum : uint8_t { OVERLAY_NONE, OVERLAY_SCROLL, OVERLAY_ANIMATION, OVERLAY_WIRING, OVERLAY_COUNTER };
+  volatile uint8_t _overlayMode;
+  uint8_t _overlay[MAX_DIGITS];
+
+#if SSFD_MARQUEE
+  // Marquee (zero-copy; the ISR reads the caller's string)
+  const char* _scrollText;
+  bool _scrollProgmem;
+  ScrollMode _scrollMode;
+  uint16_t _scrollLength;
+  int16_t _scrollPos;               // Text index shown in digit 0
+  int8_t _scrollStep;               // +1 / -1 (BOUNCE reverses it)
+  volatile uint16_t _scrollFrames;  // Frames per step
+  uint16_t _scrollCountdown;
+  unsigned long _scrollInterval;    // Step length in ms (rescaled on rate change)
+  ScrollCallback _scrollDone;
+#endif
 
-  // Blinking
-  bool _blinkEnabled;
-  volatile bool _blinkStateOn;
-  unsigned long _blinkInterval;
-  unsigned long _blinkLastToggle;
+  // Wiring test: NUM_SEGMENTS segment steps, then one step per digit
+  uint8_t _testStep;
+  volatile uint16_t _testFrames;    // Frames per step
+  uint16_t _testCountdown;
+  unsigned long _testInterval;      // Step length in ms (rescaled on rate change)
+  uint8_t _testResume;              // Overlay mode to return to
+  ScrollCallback _testDone;
+
+#if SSFD_ANIMATION
+  // Animation sequencer (zero-copy; the ISR reads the caller's PROGMEM frames)
+  struct Animation {
+    const uint8_t* frames; // frameCount rows of _numDigits patterns
+    uint8_t frameCount;
+    uint8_t fps;
+    uint8_t loops;        // 0 = forever
+    uint16_t stepFrames;  // Refresh frames per animation frame
+  };
+  Animation _anim;
+  Animation _animNext;
+  volatile bool _animQueued;
+  uint8_t _animIndex;
+  uint8_t _animLoopsLeft;
+  uint16_t _animCountdown;
+#endif
+
+#if SSFD_COUNTER
+  // Self-running counter: mixed-radix digits (10, or 6 for tens of
+  // seconds), left to right, advanced by the ISR
+  uint8_t _counterDigits[MAX_DIGITS];
+  uint8_t _counterStep[MAX_DIGITS]; // |step| in the same digits
+  bool _counterDown;
+  uint8_t _counterStepTop;          // Leftmost nonzero step digit
+  uint8_t _counterSixes;            // Tens-of-seconds digit (0xFF = none)
+  uint8_t _counterColon;            // Digit with the colon DP (0xFF = none)
+  volatile bool _counterPaused;
+  uint16_t _counterInterval;        // Period in ms
+  uint32_t _counterPeriod;          // Period in ms * refresh Hz
+  uint32_t _counterElapsed;         // Time into the period, ms * refresh Hz
+#endif
+
+  // Power management
+  bool _blankStop;                  // Stop the timer on an all-blank frame
+  volatile bool _timerGated;        // Timer stopped by the blank stop
+  volatile bool _idling;            // Timer running at _idleHz
+  uint16_t _idleAfter;              // Seconds without a new frame (0 = off)
+  uint16_t _idleHz;
+  volatile uint32_t _idleCountdown; // Frames left before idling (0 = not counting)
+
+  // Brightness: the timer's compare-B duty, faded once per frame by the ISR
+  uint8_t _brightness;
+  uint8_t _fadeTarget;
+  uint16_t _fadeLevel;              // Current level, 8.8 fixed point
+  int16_t _fadeStep;                // Added per frame, 8.8 fixed point
+  volatile uint16_t _fadeFrames;    // Frames left in the fade (0 = none)
+
+  // Per-digit levels and the tick duty each one gives at _brightness
+  uint8_t _digitLevel[MAX_DIGITS];
+  uint8_t _digitDuty[MAX_DIGITS];
+  volatile bool _digitDimmed;       // Some digit below MAX_DIGIT_LEVEL
 
   // ISR safety
   Error _lastError;
 
+  // Change detection: the last numeric setter call, so a repeat returns
+  // before composing anything
+  enum : uint8_t { SET_NONE, SET_NUMBER, SET_FLOAT, SET_FIXED, SET_INT, SET_HEX, SET_CLEAR };
+  struct SetterCall {
+    uint8_t setter;
+    int8_t arg;      // dpPosition / exponent
+    uint32_t value;  // Argument bits (float bits for setFloat())
+    Error result;
+  };
+  SetterCall _lastCall;
+
+#if SSFD_STATS
+  // Instrumentation (written by the ISR through SSFDTimer::record())
+  Stats _stats;
+  uint32_t _statsCycleSum;
+  uint32_t _statsSumTicks;   // ticks in _statsCycleSum (halved with it)
+  uint16_t _statsResolution;
+
+  /**
+   * @brief Accumulate one timed multiplex() call (ISR context)
+   */
+  void recordTick(uint16_t latencyCycles, uint16_t cycles, bool overrun);
+#endif
+
   // Helper functions
   /**
-   * @brief Convert ASCII character to 7-segment pattern
+   * @brief Convert ASCII character to 7-segment pattern (one ssfdFont read)
    * @return Segment pattern, or 0 if character not supported
+   * @note Without SSFD_TEXT only digits, A-F / a-f and '-' have a glyph
+   */
+  static uint8_t getPattern(char c);
+
+  /**
+   * @brief Convert a blink phase or scroll step in ms into frames at the current rate
+   */
+  uint16_t framesFor(unsigned long intervalMs) const;
+
+  /**
+   * @brief Mask with one bit per digit of this display
+   */
+  uint8_t allDigits() const { return (uint8_t)((1u << _numDigits) - 1); }
+
+  /**
+   * @brief Ticks in one full scan: digits, or NUM_SEGMENTS in segment order
+   */
+  uint8_t scanWidth() const {
+    return _scanOrder == ScanOrder::SEGMENTS ? NUM_SEGMENTS : _numDigits;
+  }
+
+  /**
+   * @brief Take hz as the frame rate, rescaling the frame-counted periods
+   * @note The caller retunes the timer
+   */
+  void adoptRefreshRate(uint16_t hz);
+
+  /**
+   * @brief Program the brightness on the output or timer and share it with
+   *        the displays on that timer (main or ISR context)
+   * @return false if the output or timer cannot dim
+   */
+  bool applyBrightness(uint8_t level);
+
+  /**
+   * @brief Advance a fade by one frame (ISR context)
+   */
+  void stepFade();
+
+  /**
+   * @brief Advance the wiring test by one frame (ISR context)
+   */
+  void stepWiringTest();
+
+  /**
+   * @brief Render the current wiring test step into _overlay
+   */
+  void renderWiringTest();
+
+  /**
+   * @brief Recompute _digitDuty from _digitLevel and _brightness
+   */
+  void updateDigitDuty();
+
+  /**
+   * @brief Check the timer can blank mid-tick (true before begin())
+   * @note Probes a dimmed duty, then restores the current brightness
+   */
+  bool canDim();
+
+  /**
+   * @brief Release the timer backend (stopped once no display is left on it)
+   */
+  void releaseTimer();
+
+#if SSFD_MARQUEE
+  /**
+   * @brief Arm the marquee (shared by scrollText() and scrollText_P())
+   */
+  Error startScroll(const char* text, bool progmem, uint16_t stepMs,
+                    ScrollMode mode, ScrollCallback done);
+#endif
+
+  /**
+   * @brief Rebuild _scanList for source under the current scan mode (ISR)
+   */
+  void buildScanList(const uint8_t* source);
+
+#if SSFD_MARQUEE
+  /**
+   * @brief Advance the marquee by one frame (ISR, at digit 0)
+   */
+  void stepScroll();
+
+  /**
+   * @brief Render the NUM_DIGITS characters at _scrollPos into _overlay
+   */
+  void renderScroll();
+#endif
+
+#if SSFD_ANIMATION
+  /**
+   * @brief Validate and fill an Animation (stepFrames from the current rate)
    */
-  uint8_t getPattern(char c);
+  Error makeAnimation(Animation& anim, const uint8_t* frames,
+                      uint8_t frameCount, uint8_t fps, uint8_t loops) const;
+
+  /**
+   * @brief Refresh frames per animation frame at the current rate
+   */
+  uint16_t animationFramesFor(uint8_t fps) const;
+
+  /**
+   * @brief Make anim the current animation and show its first frame
+   */
+  void loadAnimation(const Animation& anim);
+
+  /**
+   * @brief Advance the animation by one refresh frame (ISR, at digit 0)
+   */
+  void stepAnimation();
+#endif
+
+#if SSFD_COUNTER
+  /**
+   * @brief Split a count into counter digits (main context)
+   * @return false if it does not fit the display
+   */
+  bool toCounterDigits(uint32_t value, uint8_t* digits, bool minutes) const;
+
+  /**
+   * @brief Advance the counter by one frame (ISR, at digit 0)
+   */
+  void stepCounter();
+
+  /**
+   * @brief Add or subtract _counterStep once, with carry (ISR)
+   */
+  void advanceCounter();
+
+  /**
+   * @brief Render _counterDigits into _overlay
+   */
+  void renderCounter();
+#endif
+
+  /**
+   * @brief Redraw the overlay mode the wiring test paused and return to it
+   */
+  void resumeAfterWiringTest();
+
+  /**
+   * @brief Note a display change: leave idle and restart a gated timer
+   */
+  void wake();
+
+  /**
+   * @brief Check (and count) a setter call identical to the last one
+   * @return true if the frame it would compose is already published
+   */
+  bool isRepeatCall(uint8_t setter, uint32_t value, int8_t arg);
+
+  /**
+   * @brief Record the setter call that composed the current frame
+   */
+  void rememberCall(uint8_t setter, uint32_t value, int8_t arg,
+                    Error result = Error::OK);
+
+  /**
+   * @brief Count a setter call in the stats (no-op without SSFD_STATS)
+   */
+  void countUpdate(bool applied) {
+#if SSFD_STATS
+    if (applied) {
+      _stats.updatesApplied++;
+    } else {
+      _stats.updatesSkipped++;
+    }
+#else
+    (void)applied;
+#endif
+  }
+
+#if SSFD_FLOAT
+  /**
+   * @brief setFloat() body, run when the value differs from the last call
+   */
+  Error formatFloat(float value);
+#endif
+
+  /**
+   * @brief setFixed() body, run when the arguments differ from the last call
+   */
+  Error formatFixed(int32_t mantissa, int8_t exponent);
+
+  /**
+   * @brief Claim the back buffer for composing a new frame
+   * @return Buffer of _numDigits patterns, not read by the ISR until published
+   *         (the open frame while beginFrame() is staging)
+   * @note Main-context only; interrupts stay enabled while composing
+   */
+  uint8_t* backFrame();
+
+  /**
+   * @brief Publish the back buffer; shown from the next digit-0 boundary
+   * @note Not published if every glyph matches the frame on show; deferred
+   *       to commit() while a frame is open
+   */
+  void publishFrame();
+
+  /**
+   * @brief Apply (pattern & keep) | set to one digit of the staged frame
+   * @note Opens and commits a one-digit frame when none is open
+   */
+  Error stageDigit(uint8_t digit, uint8_t set, uint8_t keep);
+
+  /**
+   * @brief Claim the back buffer as the open frame (beginFrame() without
+   *        moving the print cursor)
+   */
+  void openFrame(bool clear);
+
+  /**
+   * @brief Render one streamed character into the open frame
+   * @return false if it fell past the last digit
+   */
+  bool streamChar(uint8_t c);
+
+  /**
+   * @brief Write the patterns for setNumber() into a frame buffer
+   */
+  void composeNumber(uint8_t* frame, uint32_t value, int8_t dpPosition);
+
+  /**
+   * @brief Publish digitsValue with a decimal point and optional '-' sign
+   * @param decimals Digits after the point (0 = integer)
+   */
+  void publishDecimal(bool negative, uint32_t digitsValue, uint8_t decimals);
+
+};
+
+/**
+ * @brief Direct-drive display with pins given as PROGMEM arrays
+ *
+ * Pins are resolved to port registers once in begin() and cached in SRAM,
+ * so the ISR drives each port with a single masked write. Line polarity
+ * comes from SSFD_SEGMENTS_ACTIVE_LOW / SSFD_DIGITS_ACTIVE_LOW.
+ */
+class SevenSegment : public SevenSegmentBase {
+public:
+  // ========== CONSTRUCTOR ==========
+  /**
+   * @brief Construct a SevenSegment display handler
+   * @param segmentPins PROGMEM array of 8 GPIO pins for segments (a-g, dp)
+   * @param digitPins PROGMEM array of digitCount GPIO pins for digit control
+   * @param digitCount Digits on the module (1..MAX_DIGITS)
+   * @warning Both arrays MUST be in PROGMEM and contain exactly the expected values
+   */
+  SevenSegment(const uint8_t* segmentPins, const uint8_t* digitPins,
+               uint8_t digitCount = NUM_DIGITS);
+
+protected:
+  Error beginOutput() override;
+  void drive(uint8_t segments, uint8_t digitMask) override;
+
+  // ========== PRIVATE MEMBERS ==========
+private:
+  /**
+   * @brief Output registers for one group of pins (segments or digits)
+   *
+   * Pins sharing a port (a whole GPIO bank on RP2040 / ESP32) are merged so
+   * one masked write updates the port.
+   * Bit N of the value written selects pin N of the group.
+   */
+  struct PinGroup {
+    ssfd::PortRef ports[NUM_SEGMENTS];      // Distinct ports in the group
+    ssfd::PortBits portMasks[NUM_SEGMENTS]; // All group bits on each port
+    uint8_t portCount;
+    uint8_t portIndex[NUM_SEGMENTS];        // Port slot for value bit N
+    ssfd::PortBits bitMasks[NUM_SEGMENTS];  // Port bit for value bit N (inverted if active-low)
+  };
+
+  // Pin arrays (stored as PROGMEM pointers)
+  const uint8_t* _segmentPins;
+  const uint8_t* _digitPins;
+
+  // Output registers resolved once in begin() (SRAM cache for the ISR)
+  PinGroup _segmentGroup; // Bit N = pattern bit N (bit 0 = dp)
+  PinGroup _digitGroup;   // Bit N = digit N
 
   /**
    * @brief Validate pin value
@@ -223,6 +1300,64 @@ private:
    */
   static bool isPinValid(uint8_t pin);
 
+  /**
+   * @brief Resolve a pin to its port register and add it to a group
+   * @param bit Value bit that selects this pin
+   * @param activeLow The pin is on when LOW (its bit mask is stored inverted)
+   * @return false if the pin has no output port
+   */
+  static bool addPin(PinGroup& group, uint8_t bit, uint8_t pin, bool activeLow);
+
+  /**
+   * @brief Write a value to every port of a group (masked)
+   * @tparam ActiveLow Group polarity; picks set-bit or clear-bit accumulation
+   */
+  template <bool ActiveLow>
+  static void writeGroup(const PinGroup& group, uint8_t value);
 };
 
+// ========== SSFDTimer dispatch ==========
+inline void SSFDTimer::dispatch() {
+  if (_schedule == Schedule::ROUND_ROBIN) {
+    dispatchRoundRobin();
+    return;
+  }
+  for (SevenSegmentBase* display = _clients; display != nullptr;
+       display = display->_nextClient) {
+    if (display->_isrActive) {
+      display->multiplex();
+    }
+  }
+}
+
+// ========== SSFDTimer blank ==========
+inline void SSFDTimer::blank() {
+  for (SevenSegmentBase* display = _clients; display != nullptr;
+       display = display->_nextClient) {
+    if (display->_isrActive && !display->_timerGated) {
+      display->blankOutput();
+    }
+  }
+}
+
+// ========== SSFDTimer hasSingleClient ==========
+inline bool SSFDTimer::hasSingleClient() const {
+  SevenSegmentBase* first = _clients;
+  return first != nullptr && first->_nextClient == nullptr;
+}
+
+#if SSFD_STATS
+// ========== SSFDTimer record ==========
+inline void SSFDTimer::record(uint16_t latencyTicks, uint16_t durationTicks, bool overrun) {
+  uint32_t latency = (uint32_t)latencyTicks * _cyclesPerTick;
+  uint32_t cycles = (uint32_t)durationTicks * _cyclesPerTick;
+  for (SevenSegmentBase* display = _clients; display != nullptr;
+       display = display->_nextClient) {
+    display->_statsResolution = _cyclesPerTick;
+    display->recordTick(latency > 0xFFFF ? 0xFFFF : (uint16_t)latency,
+                        cycles > 0xFFFF ? 0xFFFF : (uint16_t)cycles, overrun);
+  }
+}
+#endif
+
 #endif // SSFD_H
\ No newline at end of file
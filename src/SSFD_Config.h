@@ -0,0 +1,146 @@
+#ifndef SSFD_CONFIG_H
+#define SSFD_CONFIG_H
+
+/**
+ * @file SSFD_Config.h
+ * @brief Compile-time configuration switches for the SSFD library
+ *
+ * Every switch has a default here and can be overridden with a compiler
+ * flag (e.g. `build_flags = -DSSFD_FONT_SIZE=256` in PlatformIO). The
+ * library sources are compiled separately from the sketch, so a `#define`
+ * placed in the sketch before `#include "SSFD.h"` does not reach them;
+ * use build flags or edit this file.
+ */
+
+// ========== FONT ==========
+/**
+ * Entries in the PROGMEM font table (ssfdFont), indexed by character code:
+ * - 128: 7-bit ASCII (default)
+ * - 256: ASCII plus Latin-1; adds '°' at 0xB0 for ISO-8859-1 strings
+ */
+#ifndef SSFD_FONT_SIZE
+#define SSFD_FONT_SIZE 128
+#endif
+
+#if SSFD_FONT_SIZE != 128 && SSFD_FONT_SIZE != 256
+#error "SSFD_FONT_SIZE must be 128 or 256"
+#endif
+
+/**
+ * Degree sign in the built-in font (ASCII DEL, unused otherwise), for
+ * strings such as "21" SSFD_STR_DEGREE "C". A UTF-8 "°" in source code is
+ * two bytes and does not map to a single cell.
+ */
+#define SSFD_CHAR_DEGREE '\x7F'
+#define SSFD_STR_DEGREE "\x7F"
+
+// ========== DIGITS ==========
+/**
+ * Largest digit count any display in the sketch uses (1..8). Frame buffers
+ * are sized for it, so each display costs about 8 bytes of SRAM per digit
+ * allowed here; the count of each display is set by its constructor.
+ * Must be the same for the library and the sketch (use a build flag).
+ */
+#ifndef SSFD_MAX_DIGITS
+#define SSFD_MAX_DIGITS 4
+#endif
+
+#if SSFD_MAX_DIGITS < 1 || SSFD_MAX_DIGITS > 8
+#error "SSFD_MAX_DIGITS must be 1..8"
+#endif
+
+// ========== POLARITY ==========
+/**
+ * Level that turns a line on, for SevenSegment and SevenSegment595:
+ * - SSFD_SEGMENTS_ACTIVE_LOW 0 (default): segment HIGH = lit (common
+ *   cathode); 1: segment LOW = lit (common anode)
+ * - SSFD_DIGITS_ACTIVE_LOW 0 (default): digit HIGH = on (cathode direct or
+ *   NPN low-side driver, anode direct); 1: digit LOW = on (PNP high-side
+ *   driver, cathode direct)
+ * Resolved at compile time: the drivers select set-or-clear per bit instead
+ * of inverting at run time. SevenSegmentT takes its own SSFDPolarity
+ * argument (defaulting to these). The MAX7219 is always common cathode.
+ */
+#ifndef SSFD_SEGMENTS_ACTIVE_LOW
+#define SSFD_SEGMENTS_ACTIVE_LOW 0
+#endif
+
+#ifndef SSFD_DIGITS_ACTIVE_LOW
+#define SSFD_DIGITS_ACTIVE_LOW 0
+#endif
+
+// ========== FEATURES ==========
+/**
+ * Subsystems that can be compiled out. Each is 1 (built in) by default;
+ * SSFD_PROFILE_MINIMAL=1 turns the default of every one to 0, so a sketch
+ * that only calls setNumber() / setInt() / setHex() / print() can start
+ * from the minimal build and enable what it uses:
+ * `-DSSFD_PROFILE_MINIMAL=1 -DSSFD_BLINK=1`.
+ *
+ * - SSFD_FLOAT: setFloat() and its scale table (setFixed() needs no
+ *   floats and stays)
+ * - SSFD_TEXT: the ASCII font (ssfdFont), setText() and putChar(). Without
+ *   it, numbers, hex digits, '-' and the print() sink use a 16-glyph table
+ * - SSFD_BLINK: startBlink() and the per-frame blink phase in the ISR
+ * - SSFD_MARQUEE: scrollText() and the marquee stepper (needs SSFD_TEXT;
+ *   defaults to it)
+ * - SSFD_ANIMATION: playAnimation() and the animation sequencer
+ * - SSFD_COUNTER: startCounter() and the ISR counter / stopwatch
+ *
+ * A disabled subsystem's API is removed, so a call to it fails to compile
+ * instead of doing nothing. Instrumentation is SSFD_STATS below, off by
+ * default. The linker already drops setters a sketch never calls; these
+ * switches also remove what the ISR references (and so always links) and
+ * the state each subsystem keeps in every display object.
+ * Must be the same for the library and the sketch (use a build flag).
+ */
+#ifndef SSFD_PROFILE_MINIMAL
+#define SSFD_PROFILE_MINIMAL 0
+#endif
+
+#if SSFD_PROFILE_MINIMAL
+#define SSFD_FEATURE_DEFAULT 0
+#else
+#define SSFD_FEATURE_DEFAULT 1
+#endif
+
+#ifndef SSFD_FLOAT
+#define SSFD_FLOAT SSFD_FEATURE_DEFAULT
+#endif
+
+#ifndef SSFD_TEXT
+#define SSFD_TEXT SSFD_FEATURE_DEFAULT
+#endif
+
+#ifndef SSFD_BLINK
+#define SSFD_BLINK SSFD_FEATURE_DEFAULT
+#endif
+
+#ifndef SSFD_MARQUEE
+#define SSFD_MARQUEE SSFD_TEXT
+#endif
+
+#ifndef SSFD_ANIMATION
+#define SSFD_ANIMATION SSFD_FEATURE_DEFAULT
+#endif
+
+#ifndef SSFD_COUNTER
+#define SSFD_COUNTER SSFD_FEATURE_DEFAULT
+#endif
+
+#if SSFD_MARQUEE && !SSFD_TEXT
+#error "SSFD_MARQUEE needs SSFD_TEXT (the marquee renders through the font)"
+#endif
+
+// ========== INSTRUMENTATION ==========
+/**
+ * 1 = time every multiplex() call from the hardware timer count and expose
+ * the results through getStats() / resetStats(). 0 (default) removes the
+ * instrumentation, its state and the API entirely.
+ * Must be the same for the library and the sketch (use a build flag).
+ */
+#ifndef SSFD_STATS
+#define SSFD_STATS 0
+#endif
+
+#endif // SSFD_CONFIG_H
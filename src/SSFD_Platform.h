@@ -0,0 +1,176 @@
+#ifndef SSFD_PLATFORM_H
+#define SSFD_PLATFORM_H
+
+#include <Arduino.h>
+
+/**
+ * @file SSFD_Platform.h
+ * @brief Target detection, interrupt guard and fast GPIO writes
+ *
+ * Exactly one SSFD_ARCH_* switch is 1:
+ *
+ * | Switch              | Targets                            | Default timer     | Direct-drive GPIO            |
+ * | ------------------- | ---------------------------------- | ----------------- | ---------------------------- |
+ * | `SSFD_ARCH_AVR`     | ATmega328P/168 class (default)     | `ssfdTimer1`      | PORTx read-modify-write      |
+ * | `SSFD_ARCH_MEGAAVR` | megaAVR-0 (ATmega4809, Nano Every) | `ssfdTimerTCB0`   | VPORTx.OUT read-modify-write |
+ * | `SSFD_ARCH_RP2040`  | RP2040 (arduino-pico)              | `ssfdTimerRP2040` | SIO GPIO_OUT_XOR, one write  |
+ * | `SSFD_ARCH_ESP32`   | ESP32 family (arduino-esp32)       | `ssfdTimerESP32`  | GPIO out_w1tc / out_w1ts     |
+ *
+ * On the 32-bit targets a whole GPIO bank is one port, so a digit's
+ * segments and its digit line are written with one or two stores however
+ * they are spread over the pins.
+ */
+
+// ========== TARGET ==========
+#if defined(ARDUINO_ARCH_RP2040)
+#define SSFD_ARCH_RP2040 1
+#elif defined(ARDUINO_ARCH_ESP32)
+#define SSFD_ARCH_ESP32 1
+#elif defined(__AVR_XMEGA__) && defined(TCB0) && defined(VPORTA)
+#define SSFD_ARCH_MEGAAVR 1
+#else
+#define SSFD_ARCH_AVR 1
+#endif
+
+#ifndef SSFD_ARCH_AVR
+#define SSFD_ARCH_AVR 0
+#endif
+#ifndef SSFD_ARCH_MEGAAVR
+#define SSFD_ARCH_MEGAAVR 0
+#endif
+#ifndef SSFD_ARCH_RP2040
+#define SSFD_ARCH_RP2040 0
+#endif
+#ifndef SSFD_ARCH_ESP32
+#define SSFD_ARCH_ESP32 0
+#endif
+
+#if SSFD_ARCH_AVR || SSFD_ARCH_MEGAAVR
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#elif SSFD_ARCH_RP2040
+#include <hardware/structs/sio.h>
+#include <hardware/sync.h>
+#elif SSFD_ARCH_ESP32
+#include <soc/gpio_reg.h>
+#include <soc/soc.h>
+#include <soc/soc_caps.h>
+#endif
+
+/**
+ * Placement of the hottest functions the tick interrupt runs: IRAM on
+ * ESP32, which saves a flash cache refill on most ticks; nothing elsewhere.
+ * Only part of the path is marked (the timer driver and font tables stay in
+ * flash), so the ISR is not IRAM-safe: it is not run while the cache is off
+ */
+#if SSFD_ARCH_ESP32
+#define SSFD_ISR_ATTR IRAM_ATTR
+#else
+#define SSFD_ISR_ATTR
+#endif
+
+namespace ssfd {
+
+// ========== INTERRUPT GUARD ==========
+#if SSFD_ARCH_RP2040 || SSFD_ARCH_ESP32
+/**
+ * @brief Interrupts of the calling core off for a scope, then restored
+ * @note The tick interrupt runs on the core that called begin(); call the
+ *       library from that core
+ */
+class InterruptGuard {
+public:
+#if SSFD_ARCH_RP2040
+  InterruptGuard() : live(true), _state(save_and_disable_interrupts()) {}
+  ~InterruptGuard() { restore_interrupts(_state); }
+#else
+  InterruptGuard() : live(true), _state(portSET_INTERRUPT_MASK_FROM_ISR()) {}
+  ~InterruptGuard() { portCLEAR_INTERRUPT_MASK_FROM_ISR(_state); }
+#endif
+
+  bool live; // Cleared after the one pass of ATOMIC_BLOCK
+
+private:
+  uint32_t _state;
+};
+
+// util/atomic.h spelling, so the library sources stay the same everywhere
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_BLOCK(type)                                                   \
+  for (ssfd::InterruptGuard ssfdGuard; ssfdGuard.live; ssfdGuard.live = false)
+#endif
+
+// ========== GPIO PORTS ==========
+#if SSFD_ARCH_RP2040 || SSFD_ARCH_ESP32
+typedef uint32_t PortBits; // Pin bits of one GPIO bank
+typedef uint8_t PortRef;   // GPIO bank (0 = GPIO0..31, 1 = GPIO32..)
+#else
+typedef uint8_t PortBits;          // Pin bits of one port
+typedef volatile uint8_t* PortRef; // Output register
+#endif
+
+/**
+ * @brief Resolve an Arduino pin to its port and bit
+ * @return false if the pin cannot drive an output
+ */
+inline bool pinPort(uint8_t pin, PortRef& port, PortBits& mask) {
+#if SSFD_ARCH_RP2040
+  if (pin >= NUM_BANK0_GPIOS) {
+    return false;
+  }
+  port = 0;
+  mask = 1UL << pin;
+#elif SSFD_ARCH_ESP32
+  if (!GPIO_IS_VALID_OUTPUT_GPIO(pin)) {
+    return false;
+  }
+  port = pin >> 5;
+  mask = 1UL << (pin & 31);
+#else
+  uint8_t index = digitalPinToPort(pin);
+  if (index == NOT_A_PIN) {
+    return false;
+  }
+#if SSFD_ARCH_MEGAAVR
+  // VPORTA..F sit back to back in the I/O space: single-cycle access
+  port = &(&VPORTA)[index].OUT;
+#else
+  port = portOutputRegister(index);
+#endif
+  mask = digitalPinToBitMask(pin);
+#endif
+  return true;
+}
+
+/**
+ * @brief Set the pins in mask to levels (bits outside mask are zero)
+ * @note ISR context. Pins of the port outside mask are not changed
+ */
+inline SSFD_ISR_ATTR void writePort(PortRef port, PortBits mask, PortBits levels) {
+#if SSFD_ARCH_RP2040
+  // Flip exactly the pins that differ: every pin of the group switches in
+  // the same cycle, and the other pins of the bank are never written
+  (void)port;
+  sio_hw->gpio_togl = (sio_hw->gpio_out ^ levels) & mask;
+#elif SSFD_ARCH_ESP32
+  // GPIO.out_w1tc / out_w1ts by address (the struct layout differs between
+  // chips). Off first, then on: a lit pin is never carried into the new
+  // levels
+#if SOC_GPIO_PIN_COUNT > 32
+  if (port != 0) {
+    REG_WRITE(GPIO_OUT1_W1TC_REG, mask & ~levels);
+    REG_WRITE(GPIO_OUT1_W1TS_REG, levels);
+    return;
+  }
+#endif
+  (void)port;
+  REG_WRITE(GPIO_OUT_W1TC_REG, mask & ~levels);
+  REG_WRITE(GPIO_OUT_W1TS_REG, levels);
+#else
+  *port = (*port & (PortBits)~mask) | levels;
+#endif
+}
+
+} // namespace ssfd
+
+#endif // SSFD_PLATFORM_H
@@ -0,0 +1,251 @@
+/**
+ * @file SSFD_SPI.cpp
+ * @brief Hardware-SPI output drivers (74HC595 chain, MAX7219)
+ */
+
+#include "SSFD.h"
+
+#if SSFD_ARCH_AVR
+#include "SSFD_SPI.h"
+
+// ========== SPI HELPERS ==========
+/**
+ * Master, mode 0, MSB first, F_CPU / 2
+ */
+static void spiBegin()
+{
+    digitalWrite(SS, HIGH);
+    pinMode(SS, OUTPUT); // Must stay an output or the SPI drops to slave mode
+    pinMode(MOSI, OUTPUT);
+    pinMode(SCK, OUTPUT);
+    SPCR = (1 << SPE) | (1 << MSTR);
+    SPSR = (1 << SPI2X);
+}
+
+static inline void spiWait()
+{
+    while (!(SPSR & (1 << SPIF)))
+    {
+    }
+}
+
+static inline void spiTransfer(uint8_t value)
+{
+    SPDR = value;
+    spiWait();
+}
+
+// ========== SevenSegment595 ==========
+/**
+ * Output byte for a segment pattern / digit mask with the polarity of
+ * SSFD_Config.h (a compile-time choice; active-high is the value itself)
+ */
+static inline uint8_t segmentLevels(uint8_t segments)
+{
+    return SSFD_SEGMENTS_ACTIVE_LOW ? (uint8_t)~segments : segments;
+}
+
+static inline uint8_t digitLevels(uint8_t digitMask)
+{
+    return SSFD_DIGITS_ACTIVE_LOW ? (uint8_t)~digitMask : digitMask;
+}
+
+SevenSegment595::SevenSegment595(uint8_t latchPin, uint8_t digitCount)
+    : SevenSegmentBase(digitCount),
+      _latchPin(latchPin),
+      _latchPort(nullptr),
+      _latchMask(0),
+      _latchPending(false),
+      _queuedDigits(0),
+      _queuedSegments(0)
+{
+    _deferredOutput = true;
+}
+
+// ========== beginOutput() ==========
+SevenSegment595::Error SevenSegment595::beginOutput()
+{
+    uint8_t port = digitalPinToPort(_latchPin);
+    if (port == NOT_A_PIN)
+    {
+        return Error::INVALID_PIN;
+    }
+
+    _latchPort = portOutputRegister(port);
+    _latchMask = digitalPinToBitMask(_latchPin);
+    pinMode(_latchPin, OUTPUT);
+    digitalWrite(_latchPin, LOW);
+
+    spiBegin();
+
+    // Start dark
+    spiTransfer(digitLevels(0));
+    spiTransfer(segmentLevels(0));
+    _latchPending = true;
+    latch();
+    return Error::OK;
+}
+
+// ========== latch() ==========
+void SevenSegment595::latch()
+{
+    if (_latchPending)
+    {
+        spiWait(); // Normally long finished
+        *_latchPort |= _latchMask;
+        *_latchPort &= ~_latchMask;
+        _latchPending = false;
+    }
+}
+
+// ========== drive() ==========
+void SevenSegment595::drive(uint8_t segments, uint8_t digitMask)
+{
+    // Show what the previous tick sent, then queue this tick's bytes.
+    // The 595 latch updates segments and digits together (no ghosting).
+    latch();
+    _queuedDigits = digitLevels(digitMask);
+    _queuedSegments = segmentLevels(segments);
+    spiTransfer(_queuedDigits);
+    SPDR = _queuedSegments; // Fire and forget; latched next tick
+    _latchPending = true;
+}
+
+// ========== blankOutput() ==========
+void SevenSegment595::blankOutput()
+{
+    // The digit on show is already latched and the next one is queued in
+    // the shift registers: latch a dark pair, then queue that digit again
+    bool queued = _latchPending;
+    spiWait();
+    spiTransfer(digitLevels(0));
+    spiTransfer(segmentLevels(0));
+    _latchPending = true;
+    latch();
+
+    if (queued)
+    {
+        spiTransfer(_queuedDigits);
+        SPDR = _queuedSegments;
+        _latchPending = true;
+    }
+}
+
+// ========== flushOutput() ==========
+void SevenSegment595::flushOutput()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        latch();
+    }
+}
+
+// ========== SevenSegmentMax7219 ==========
+// Register addresses
+static const uint8_t MAX7219_DIGIT0 = 0x01;
+static const uint8_t MAX7219_DECODE_MODE = 0x09;
+static const uint8_t MAX7219_INTENSITY = 0x0A;
+static const uint8_t MAX7219_SCAN_LIMIT = 0x0B;
+static const uint8_t MAX7219_SHUTDOWN = 0x0C;
+static const uint8_t MAX7219_DISPLAY_TEST = 0x0F;
+
+/**
+ * SSFD bit layout (7=a .. 1=g, 0=dp) to MAX7219 no-decode (7=dp, 6=a .. 0=g)
+ */
+static inline uint8_t toMax7219(uint8_t pattern)
+{
+    return (pattern >> 1) | (pattern << 7);
+}
+
+SevenSegmentMax7219::SevenSegmentMax7219(uint8_t csPin, uint8_t intensity,
+                                         uint8_t digitCount)
+    : SevenSegmentBase(digitCount),
+      _csPin(csPin),
+      _intensity(intensity > 15 ? 15 : intensity),
+      _ready(false)
+{
+    _selfRefreshing = true;
+}
+
+// ========== writeRegister() ==========
+void SevenSegmentMax7219::writeRegister(uint8_t reg, uint8_t value)
+{
+    digitalWrite(_csPin, LOW);
+    spiTransfer(reg);
+    spiTransfer(value);
+    digitalWrite(_csPin, HIGH); // Data latched on the rising edge
+}
+
+// ========== beginOutput() ==========
+SevenSegmentMax7219::Error SevenSegmentMax7219::beginOutput()
+{
+    if (digitalPinToPort(_csPin) == NOT_A_PIN)
+    {
+        return Error::INVALID_PIN;
+    }
+
+    digitalWrite(_csPin, HIGH);
+    pinMode(_csPin, OUTPUT);
+    spiBegin();
+
+    writeRegister(MAX7219_DISPLAY_TEST, 0);
+    writeRegister(MAX7219_DECODE_MODE, 0); // Raw segment patterns
+    writeRegister(MAX7219_SCAN_LIMIT, getDigitCount() - 1);
+    writeRegister(MAX7219_INTENSITY, _intensity);
+    writeRegister(MAX7219_SHUTDOWN, 1);
+    _ready = true;
+    return Error::OK;
+}
+
+// ========== setIntensity() ==========
+void SevenSegmentMax7219::setIntensity(uint8_t intensity)
+{
+    _intensity = intensity > 15 ? 15 : intensity;
+    if (_ready)
+    {
+        writeRegister(MAX7219_INTENSITY, _intensity);
+    }
+}
+
+// ========== outputBrightness() ==========
+bool SevenSegmentMax7219::outputBrightness(uint8_t level)
+{
+    setIntensity(level >> 4);
+    return true;
+}
+
+// ========== drive() ==========
+void SevenSegmentMax7219::drive(uint8_t segments, uint8_t digitMask)
+{
+    // Only used outside the ISR (testWiring, end); the chip scans by itself
+    if (!_ready)
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < getDigitCount(); i++)
+    {
+        uint8_t pattern = (digitMask & (1 << i)) ? segments : 0;
+        writeRegister(MAX7219_DIGIT0 + i, toMax7219(pattern));
+    }
+}
+
+// ========== frameUpdated() ==========
+void SevenSegmentMax7219::frameUpdated(const uint8_t *frame, const uint8_t *previous)
+{
+    if (!_ready)
+    {
+        return;
+    }
+
+    // Push only the digits whose pattern changed
+    for (uint8_t i = 0; i < getDigitCount(); i++)
+    {
+        if (previous == nullptr || frame[i] != previous[i])
+        {
+            writeRegister(MAX7219_DIGIT0 + i, toMax7219(frame[i]));
+        }
+    }
+}
+
+#endif // SSFD_ARCH_AVR
@@ -0,0 +1,108 @@
+#ifndef SSFD_SPI_H
+#define SSFD_SPI_H
+
+#include "SSFD.h"
+
+/**
+ * @file SSFD_SPI.h
+ * @brief Hardware-SPI output drivers (74HC595 chain, MAX7219)
+ *
+ * Both drivers use the AVR SPI peripheral directly through SPCR/SPSR/SPDR
+ * (MOSI, SCK and SS are configured as outputs; SS must remain an output),
+ * so they are only available on ATmega328P-class targets (SSFD_ARCH_AVR).
+ * The display owns the SPI bus: other SPI devices must not be accessed
+ * while the multiplex ISR can run, or the transfers will interleave.
+ */
+
+#if !SSFD_ARCH_AVR
+#error "SSFD_SPI.h: the SPI drivers need the ATmega328P-class SPI peripheral"
+#endif
+
+/**
+ * @brief Two chained 74HC595 shift registers on hardware SPI
+ *
+ * Each tick sends two bytes and pulses the latch, so multiplexing costs a
+ * few register writes instead of GPIO bit work. The transfer is
+ * fire-and-forget: the second byte shifts out after the ISR returns and is
+ * latched at the start of the next tick, so every digit is shown for one
+ * full tick, one tick late.
+ *
+ * **Wiring (MSB first):**
+ * - U1 (nearest MOSI): QH..QA = segments a, b, c, d, e, f, g, dp
+ * - U2 (cascaded from U1 QH'): QA..QH = digits 1..8 (HIGH = digit on)
+ * - Either byte is sent inverted when SSFD_SEGMENTS_ACTIVE_LOW /
+ *   SSFD_DIGITS_ACTIVE_LOW is set (common anode, PNP digit drivers)
+ * - RCLK of both chips = latchPin
+ */
+class SevenSegment595 : public SevenSegmentBase {
+public:
+  /**
+   * @param latchPin GPIO connected to RCLK (storage clock) of both 595s
+   * @param digitCount Digits wired to U2 (1..MAX_DIGITS)
+   */
+  explicit SevenSegment595(uint8_t latchPin, uint8_t digitCount = NUM_DIGITS);
+
+protected:
+  Error beginOutput() override;
+  void drive(uint8_t segments, uint8_t digitMask) override;
+  void flushOutput() override;
+  void blankOutput() override;
+
+private:
+  uint8_t _latchPin;
+  volatile uint8_t* _latchPort; // Cached for the ISR
+  uint8_t _latchMask;
+  volatile bool _latchPending;    // Bytes sent, not latched yet
+  uint8_t _queuedDigits;          // Output bytes of the pending pair
+  uint8_t _queuedSegments;
+
+  void latch();
+};
+
+/**
+ * @brief MAX7219 / MAX7221 driver (chip multiplexes the digits itself)
+ *
+ * No timer is used: published frames are pushed over SPI right away and only
+ * digits whose pattern changed are sent. ISR-timed features (blinking) are
+ * not available with this driver.
+ *
+ * **Wiring:** DIN = MOSI, CLK = SCK, LOAD/CS = csPin, DIG0..DIG7 = digits 1..8
+ * (the scan limit is set to the digit count, so unused DIGx stay off)
+ */
+class SevenSegmentMax7219 : public SevenSegmentBase {
+public:
+  /**
+   * @param csPin GPIO connected to LOAD/CS
+   * @param intensity Initial brightness 0..15
+   * @param digitCount Digits wired to DIG0.. (1..MAX_DIGITS)
+   */
+  explicit SevenSegmentMax7219(uint8_t csPin, uint8_t intensity = 8,
+                               uint8_t digitCount = NUM_DIGITS);
+
+  /**
+   * @brief Initialize the chip; no timer backend is used
+   */
+  Error begin() { return SevenSegmentBase::begin(ssfdExternalTick); }
+
+  /**
+   * @brief Set the chip's brightness register
+   * @param intensity 0..15 (clamped)
+   * @note setBrightness(level) sets the same register to level / 16
+   */
+  void setIntensity(uint8_t intensity);
+
+protected:
+  Error beginOutput() override;
+  void drive(uint8_t segments, uint8_t digitMask) override;
+  void frameUpdated(const uint8_t* frame, const uint8_t* previous) override;
+  bool outputBrightness(uint8_t level) override;
+
+private:
+  uint8_t _csPin;
+  uint8_t _intensity;
+  bool _ready;
+
+  void writeRegister(uint8_t reg, uint8_t value);
+};
+
+#endif // SSFD_SPI_H
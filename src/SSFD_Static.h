@@ -0,0 +1,244 @@
+#ifndef SSFD_STATIC_H
+#define SSFD_STATIC_H
+
+#include "SSFD.h"
+
+/**
+ * @file SSFD_Static.h
+ * @brief Compile-time pin-mapped SevenSegment driver
+ *
+ * SevenSegmentT takes its pins as template arguments and computes every
+ * port register and mask at compile time, so the ISR drive() compiles to a
+ * handful of constant port writes with no SRAM lookups. Font, frame and
+ * formatting code are shared with SevenSegment through SevenSegmentBase.
+ *
+ * When segments a..dp are wired to bits 7..0 of a single port, the segment
+ * update collapses to one `out` instruction.
+ *
+ * **Usage:**
+ * ```cpp
+ * #include "SSFD_Static.h"
+ *
+ * SevenSegmentT<SSFDPins<2, 3, 4, 5, 6, 7, 8, 9>,  // a, b, c, d, e, f, g, dp
+ *               SSFDPins<10, 11, 12, 13>> display;  // digits 1..4
+ * ```
+ *
+ * The digit count is the length of the digit pin list (1..MAX_DIGITS).
+ *
+ * An optional third argument sets the line polarity, e.g. a common-anode
+ * module with PNP digit drivers:
+ * ```cpp
+ * SevenSegmentT<SSFDPins<2, 3, 4, 5, 6, 7, 8, 9>, SSFDPins<10, 11, 12, 13>,
+ *               SSFDCommonAnode> display;
+ * ```
+ * The polarity picks set-or-clear for each bit at compile time, so an
+ * active-low drive() is the same instructions as an active-high one (one
+ * extra `com` for a segment port written whole).
+ *
+ * @note Pin numbers are mapped with the ATmega328P (Uno/Nano) pinout.
+ */
+
+#if !defined(__AVR_ATmega328P__) && !defined(__AVR_ATmega328__) && \
+    !defined(__AVR_ATmega168__) && !defined(__AVR_ATmega168P__)
+#error "SSFD_Static.h: compile-time pin map only available for ATmega328P/168"
+#endif
+
+/**
+ * @brief Compile-time list of Arduino pin numbers
+ */
+template <uint8_t... Pins>
+struct SSFDPins {
+  static constexpr uint8_t COUNT = sizeof...(Pins);
+};
+
+/**
+ * @brief Compile-time line polarity for SevenSegmentT
+ * @tparam SegmentsActiveLow Segment lit when its pin is LOW (common anode)
+ * @tparam DigitsActiveLow Digit on when its pin is LOW (PNP high-side driver)
+ */
+template <bool SegmentsActiveLow = SSFD_SEGMENTS_ACTIVE_LOW,
+          bool DigitsActiveLow = SSFD_DIGITS_ACTIVE_LOW>
+struct SSFDPolarity {
+  static constexpr bool SEGMENTS_ACTIVE_LOW = SegmentsActiveLow;
+  static constexpr bool DIGITS_ACTIVE_LOW = DigitsActiveLow;
+};
+
+typedef SSFDPolarity<false, false> SSFDCommonCathode; // Segments HIGH, digits HIGH (NPN)
+typedef SSFDPolarity<true, true> SSFDCommonAnode;     // Segments LOW, digits LOW (PNP)
+
+namespace ssfd {
+
+// ========== PIN MAP (ATmega328P) ==========
+enum : uint8_t { PORT_NONE = 0, PORT_B = 2, PORT_C = 3, PORT_D = 4 };
+
+/**
+ * @brief Port of an Arduino pin (D0-D7 = PORTD, D8-D13 = PORTB, A0-A5 = PORTC)
+ */
+constexpr uint8_t pinPort(uint8_t pin) {
+  return pin < 8 ? PORT_D : pin < 14 ? PORT_B : pin < 20 ? PORT_C : PORT_NONE;
+}
+
+/**
+ * @brief Port bit mask of an Arduino pin
+ */
+constexpr uint8_t pinBit(uint8_t pin) {
+  return pin < 8 ? (1 << pin) : pin < 14 ? (1 << (pin - 8)) : (1 << (pin - 14));
+}
+
+/**
+ * @brief True if every pin in the list has a port
+ */
+constexpr bool pinsValid() { return true; }
+template <typename... Rest>
+constexpr bool pinsValid(uint8_t pin, Rest... rest) {
+  return pinPort(pin) != PORT_NONE && pinsValid(rest...);
+}
+
+/**
+ * @brief OR of the bit masks of all pins that sit on a port
+ */
+constexpr uint8_t portMask(uint8_t) { return 0; }
+template <typename... Rest>
+constexpr uint8_t portMask(uint8_t port, uint8_t pin, Rest... rest) {
+  return (pinPort(pin) == port ? pinBit(pin) : 0) | portMask(port, rest...);
+}
+
+/**
+ * @brief True if pins map value bits 7..0 onto bits 7..0 of one port
+ * @param bit Value bit expected for the first pin in the list
+ */
+constexpr bool isDirectMap(uint8_t, int8_t) { return true; }
+template <typename... Rest>
+constexpr bool isDirectMap(uint8_t port, int8_t bit, uint8_t pin, Rest... rest) {
+  return pinPort(pin) == port && pinBit(pin) == (1 << bit) &&
+         isDirectMap(port, bit - 1, rest...);
+}
+
+/**
+ * @brief Port bits for a segment pattern (first pin = pattern bit 7)
+ * @tparam ActiveLow Set the pins of unlit segments instead of lit ones
+ */
+template <bool ActiveLow>
+inline __attribute__((always_inline)) uint8_t segmentBits(uint8_t, uint8_t) {
+  return 0;
+}
+template <bool ActiveLow, typename... Rest>
+inline __attribute__((always_inline)) uint8_t segmentBits(uint8_t port, uint8_t value,
+                                                          uint8_t pin, Rest... rest) {
+  return ((pinPort(pin) == port && ((value & 0x80) != 0) != ActiveLow) ? pinBit(pin) : 0) |
+         segmentBits<ActiveLow>(port, (uint8_t)(value << 1), rest...);
+}
+
+/**
+ * @brief Port bits for a digit mask (first pin = mask bit 0)
+ * @tparam ActiveLow Set the pins of digits that are off instead of on
+ */
+template <bool ActiveLow>
+inline __attribute__((always_inline)) uint8_t digitBits(uint8_t, uint8_t) {
+  return 0;
+}
+template <bool ActiveLow, typename... Rest>
+inline __attribute__((always_inline)) uint8_t digitBits(uint8_t port, uint8_t value,
+                                                        uint8_t pin, Rest... rest) {
+  return ((pinPort(pin) == port && ((value & 0x01) != 0) != ActiveLow) ? pinBit(pin) : 0) |
+         digitBits<ActiveLow>(port, (uint8_t)(value >> 1), rest...);
+}
+
+/**
+ * @brief Output register of a port (folds to a constant address)
+ */
+inline __attribute__((always_inline)) volatile uint8_t& portRegister(uint8_t port) {
+  return port == PORT_B ? PORTB : port == PORT_C ? PORTC : PORTD;
+}
+
+/**
+ * @brief Masked port write; plain store when the group owns the whole port
+ */
+inline __attribute__((always_inline)) void writePort(uint8_t port, uint8_t mask,
+                                                     uint8_t bits) {
+  if (mask == 0) {
+    return;
+  }
+  volatile uint8_t& reg = portRegister(port);
+  if (mask == 0xFF) {
+    reg = bits;
+  } else {
+    reg = (reg & ~mask) | bits;
+  }
+}
+
+} // namespace ssfd
+
+template <typename SegmentPins, typename DigitPins, typename Polarity = SSFDPolarity<>>
+class SevenSegmentT;
+
+/**
+ * @brief Direct-drive display with pins fixed at compile time
+ * @tparam Seg Segment pins a, b, c, d, e, f, g, dp
+ * @tparam Dig Digit pins, left to right (one per digit)
+ * @tparam Polarity SSFDPolarity of the segment and digit lines
+ */
+template <uint8_t... Seg, uint8_t... Dig, typename Polarity>
+class SevenSegmentT<SSFDPins<Seg...>, SSFDPins<Dig...>, Polarity> : public SevenSegmentBase {
+  static_assert(sizeof...(Seg) == NUM_SEGMENTS, "SevenSegmentT needs 8 segment pins");
+  static_assert(sizeof...(Dig) >= 1 && sizeof...(Dig) <= MAX_DIGITS,
+                "SevenSegmentT needs 1..SSFD_MAX_DIGITS digit pins");
+  static_assert(ssfd::pinsValid(Seg...) && ssfd::pinsValid(Dig...),
+                "SevenSegmentT pin has no output port");
+
+public:
+  SevenSegmentT() : SevenSegmentBase(sizeof...(Dig)) {}
+
+protected:
+  Error beginOutput() override {
+    // Off level first, so no line lights briefly
+    const uint8_t segments[] = {Seg...};
+    for (uint8_t i = 0; i < sizeof(segments); i++) {
+      digitalWrite(segments[i], SEG_LOW ? HIGH : LOW);
+      pinMode(segments[i], OUTPUT);
+    }
+    const uint8_t digits[] = {Dig...};
+    for (uint8_t i = 0; i < sizeof(digits); i++) {
+      digitalWrite(digits[i], DIG_LOW ? HIGH : LOW);
+      pinMode(digits[i], OUTPUT);
+    }
+    return Error::OK;
+  }
+
+  void drive(uint8_t segments, uint8_t digitMask) override {
+    writeDigits(0);
+    writeSegments<ssfd::PORT_B>(segments);
+    writeSegments<ssfd::PORT_C>(segments);
+    writeSegments<ssfd::PORT_D>(segments);
+    writeDigits(digitMask);
+  }
+
+private:
+  static constexpr bool SEG_LOW = Polarity::SEGMENTS_ACTIVE_LOW;
+  static constexpr bool DIG_LOW = Polarity::DIGITS_ACTIVE_LOW;
+
+  template <uint8_t Port>
+  static inline __attribute__((always_inline)) void writeSegments(uint8_t segments) {
+    constexpr uint8_t mask = ssfd::portMask(Port, Seg...);
+    constexpr bool direct = ssfd::isDirectMap(Port, 7, Seg...);
+    if (direct) {
+      ssfd::portRegister(Port) = SEG_LOW ? (uint8_t)~segments : segments; // Single `out`
+    } else {
+      ssfd::writePort(Port, mask, ssfd::segmentBits<SEG_LOW>(Port, segments, Seg...));
+    }
+  }
+
+  template <uint8_t Port>
+  static inline __attribute__((always_inline)) void writeDigitPort(uint8_t digitMask) {
+    constexpr uint8_t mask = ssfd::portMask(Port, Dig...);
+    ssfd::writePort(Port, mask, ssfd::digitBits<DIG_LOW>(Port, digitMask, Dig...));
+  }
+
+  static inline __attribute__((always_inline)) void writeDigits(uint8_t digitMask) {
+    writeDigitPort<ssfd::PORT_B>(digitMask);
+    writeDigitPort<ssfd::PORT_C>(digitMask);
+    writeDigitPort<ssfd::PORT_D>(digitMask);
+  }
+};
+
+#endif // SSFD_STATIC_H
@@ -0,0 +1,485 @@
+#ifndef SSFD_TIMER_H
+#define SSFD_TIMER_H
+
+#include <Arduino.h>
+#include "SSFD_Config.h"
+#include "SSFD_Platform.h"
+
+/**
+ * @file SSFD_Timer.h
+ * @brief Timer backends that schedule SevenSegment multiplexing
+ *
+ * A backend owns one hardware timer (or none, for external ticks) and calls
+ * its attached displays once per digit tick. Several displays can share one
+ * backend (see SSFDTimer::Schedule), so a panel of modules needs one timer. Each AVR backend lives in its
+ * own translation unit together with its ISR; with `dot_a_linkage` only the
+ * backends a sketch actually passes to begin() are linked, so unused timer
+ * vectors stay free for other code.
+ *
+ * | Backend            | Target    | Vector / source     | Notes                              |
+ * | ------------------ | --------- | ------------------- | ---------------------------------- |
+ * | `ssfdTimer1`       | ATmega328P| TIMER1_COMPA_vect   | Default; 16-bit CTC                |
+ * | `ssfdTimer2`       | ATmega328P| TIMER2_COMPA_vect   | 8-bit CTC; conflicts with tone()   |
+ * | `ssfdTimer0B`      | ATmega328P| TIMER0_COMPB_vect   | Shares millis() timer; see below   |
+ * | `ssfdTimerTCB0`    | megaAVR-0 | TCB0_INT_vect       | Default; 16-bit periodic interrupt |
+ * | `ssfdTimerRP2040`  | RP2040    | Hardware alarms     | Default; 1 us resolution           |
+ * | `ssfdTimerESP32`   | ESP32     | Hardware timer      | Default; 1 us resolution           |
+ * | `ssfdExternalTick` | any       | none                | Call dispatch() from your own ISR  |
+ *
+ * Timer1 and Timer2 also use their compare-B vector (TIMER1_COMPB_vect /
+ * TIMER2_COMPB_vect) for brightness control, and ssfdTimerRP2040 a second
+ * alarm; they are only enabled below full brightness. Only the backends of
+ * the target being built are declared (see SSFD_Platform.h);
+ * SSFD_DEFAULT_TIMER names the one begin() uses.
+ */
+
+class SevenSegmentBase;
+
+/**
+ * @brief Scheduling backend interface
+ */
+class SSFDTimer {
+public:
+  /**
+   * @brief Program the timer and enable its interrupt
+   * @param tickHz Digit interrupts per second
+   * @return false if the rate cannot be reached on this timer
+   */
+  virtual bool start(uint32_t tickHz) = 0;
+
+  /**
+   * @brief Disable the timer interrupt
+   */
+  virtual void stop() = 0;
+
+  /**
+   * @brief Retune a running timer without stopping it
+   * @param tickHz Digit interrupts per second
+   * @return false if the rate cannot be reached (old rate is kept)
+   */
+  virtual bool setRate(uint32_t tickHz) = 0;
+
+  /**
+   * @brief Make the period that just started last several ticks (ISR context)
+   * @param ticks Base periods wanted; 1 restores the programmed period
+   * @return Base periods the running period now lasts (1 = not stretched),
+   *         limited by the compare register width
+   * @note Used for the dark tick of ScanMode::SKIP_FEWER_TICKS
+   */
+  virtual uint8_t stretchTick(uint8_t ticks) {
+    (void)ticks;
+    return 1;
+  }
+
+  static constexpr uint8_t FULL_DUTY = 255;
+
+  /**
+   * @brief Blank the lit digits partway through every tick (dimming)
+   * @param duty Lit share of each tick in 1/256 steps; FULL_DUTY = the
+   *        whole tick, with the second compare channel switched off
+   * @return false if the backend has no second compare channel (only
+   *         FULL_DUTY succeeds)
+   * @note Main or ISR context. The compare-B interrupt calls blank(); the
+   *       compare point follows setRate() and start()
+   */
+  virtual bool setDuty(uint8_t duty) { return duty == FULL_DUTY; }
+
+  /**
+   * @brief Set the lit share of the tick that just started only (ISR
+   *        context, called right after the digit is driven)
+   * @param duty As for setDuty(); the next setDuty(), setRate() or
+   *        tickDuty() call replaces it
+   * @note Per-digit brightness. If the on-time has already run out, the
+   *       digit is blanked at once. No effect without a second compare
+   *       channel
+   */
+  virtual void tickDuty(uint8_t duty) { (void)duty; }
+
+  /**
+   * @brief How the attached displays share the timer interrupt
+   */
+  enum class Schedule : uint8_t {
+    PARALLEL,   // Every display scans one digit per tick (separate outputs)
+    ROUND_ROBIN // One display at a time, digit by digit (shared segment lines)
+  };
+
+  /**
+   * @brief Choose how several displays share this timer
+   * @note PARALLEL (default) ticks at refresh x the largest digit count and
+   *       suits displays on separate segment lines. ROUND_ROBIN lights a
+   *       single digit across all displays per tick, so displays wired to
+   *       the same segment lines never fight; it ticks at refresh x the sum
+   *       of the digit counts. A running timer is retuned in place
+   */
+  void setSchedule(Schedule schedule);
+
+  /**
+   * @brief Get the schedule set by setSchedule()
+   */
+  Schedule getSchedule() const { return _schedule; }
+
+  /**
+   * @brief Ticks per full frame for the attached displays
+   * @return Largest scan width (PARALLEL) or sum of scan widths
+   *         (ROUND_ROBIN); 0 with no display attached. A display's width is
+   *         its digit count, or NUM_SEGMENTS in ScanOrder::SEGMENTS
+   */
+  uint8_t ticksPerFrame() const;
+
+  /**
+   * @brief Add a display to the ones driven by this timer (called by begin())
+   * @note Displays are scanned in the order they were attached
+   */
+  void attach(SevenSegmentBase* display);
+
+  /**
+   * @brief Remove a display (called by end() and by a later begin())
+   */
+  void detach(SevenSegmentBase* display);
+
+  /**
+   * @brief Run one multiplex step on the attached displays (ISR context)
+   */
+  inline void dispatch();
+
+  /**
+   * @brief Switch off what the attached displays lit this tick (ISR context)
+   */
+  inline void blank();
+
+#if SSFD_STATS
+  /**
+   * @brief Report the timing of the last dispatch() to the displays (ISR context)
+   * @param latencyTicks Timer counts from the compare match to ISR entry
+   * @param durationTicks Timer counts spent in dispatch()
+   * @param overrun The next compare match was already pending at exit
+   */
+  inline void record(uint16_t latencyTicks, uint16_t durationTicks, bool overrun);
+#endif
+
+protected:
+#if SSFD_STATS
+  SSFDTimer()
+      : _clients(nullptr), _turn(nullptr), _turnEnded(false),
+        _schedule(Schedule::PARALLEL), _cyclesPerTick(1) {}
+#else
+  SSFDTimer()
+      : _clients(nullptr), _turn(nullptr), _turnEnded(false),
+        _schedule(Schedule::PARALLEL) {}
+#endif
+
+  // Attached displays, linked through SevenSegmentBase::_nextClient
+  SevenSegmentBase* volatile _clients;
+
+  // ROUND_ROBIN: display whose scan runs, and whether that scan just ended
+  SevenSegmentBase* _turn;
+  bool _turnEnded;
+  Schedule _schedule;
+
+#if SSFD_STATS
+  uint16_t _cyclesPerTick; // CPU cycles per timer count (prescaler)
+#endif
+
+private:
+  friend class SevenSegmentBase;
+
+  /**
+   * @brief Give every client its scan period for the current schedule
+   */
+  void retune();
+
+  /**
+   * @brief Displays attached, begun and not blank-stopped
+   */
+  uint8_t activeClients() const;
+
+  /**
+   * @brief True with exactly one display attached (may stretch and idle)
+   */
+  inline bool hasSingleClient() const;
+
+  /**
+   * @brief ROUND_ROBIN step: advance the current display, hand over at its
+   *        scan end (ISR context)
+   */
+  void dispatchRoundRobin();
+};
+
+#if SSFD_ARCH_AVR
+/**
+ * @brief CTC backend shared by Timer1 and Timer2: compare A ticks, compare
+ *        B dims
+ * @tparam Regs Registers, prescalers and counter width of one timer (see
+ *         SSFDTimer1Regs); every register access is to a constant address
+ * @note Defined in SSFD_TimerCTC.h and instantiated by each timer's own
+ *       translation unit
+ */
+template <class Regs>
+class SSFDTimerCTC : public SSFDTimer {
+public:
+  SSFDTimerCTC() : _top(0), _duty(FULL_DUTY) {}
+
+  bool start(uint32_t tickHz) override;
+  void stop() override;
+  bool setRate(uint32_t tickHz) override;
+  uint8_t stretchTick(uint8_t ticks) override;
+  bool setDuty(uint8_t duty) override;
+  void tickDuty(uint8_t duty) override;
+
+private:
+  typedef typename Regs::Count Count;
+
+  static bool settings(uint32_t tickHz, uint8_t& csBits, Count& top,
+                       uint16_t& prescaler);
+
+  Count _top;    // Programmed compare value
+  uint8_t _duty; // Lit share of a tick (compare B)
+
+  /**
+   * @brief Compare-B value that ends the lit share of a tick
+   */
+  Count dutyMatch(uint8_t duty) const {
+    return (Count)(((typename Regs::Wide)_top + 1) * duty >> 8);
+  }
+
+  /**
+   * @brief Program compare B from _top and _duty (interrupts disabled)
+   */
+  void applyDuty();
+};
+
+/**
+ * @brief Timer1 registers for SSFDTimerCTC (16-bit counter)
+ */
+struct SSFDTimer1Regs {
+  typedef uint16_t Count;
+  typedef uint32_t Wide;                     // Holds (top + 1) x 255
+  static constexpr uint32_t RANGE = 65536UL; // Counts per period, at most
+  static constexpr uint8_t PRESCALERS = 5;
+
+  static uint16_t prescaler(uint8_t i); // Table in SSFD_Timer1.cpp
+  static uint8_t clockBits(uint8_t i);  // CS12..CS10 for prescaler(i)
+
+  // Stop the clock; WGM12 (CTC) is set again by run()
+  static void halt() {
+    TCCR1A = 0;
+    TCCR1B = 0;
+  }
+  static void run(uint8_t csBits) { TCCR1B = (1 << WGM12) | csBits; }
+
+  static volatile uint16_t& counter() { return TCNT1; }
+  static volatile uint16_t& compareA() { return OCR1A; }
+  static volatile uint16_t& compareB() { return OCR1B; }
+  static volatile uint8_t& mask() { return TIMSK1; }
+  static volatile uint8_t& flags() { return TIFR1; }
+  static constexpr uint8_t IE_A = 1 << OCIE1A;
+  static constexpr uint8_t IE_B = 1 << OCIE1B;
+  static constexpr uint8_t F_A = 1 << OCF1A;
+  static constexpr uint8_t F_B = 1 << OCF1B;
+};
+
+/**
+ * @brief Timer2 registers for SSFDTimerCTC (8-bit counter)
+ */
+struct SSFDTimer2Regs {
+  typedef uint8_t Count;
+  typedef uint16_t Wide;
+  static constexpr uint32_t RANGE = 256;
+  static constexpr uint8_t PRESCALERS = 7;
+
+  static uint16_t prescaler(uint8_t i); // Table in SSFD_Timer2.cpp
+  static uint8_t clockBits(uint8_t i) { return i + 1; } // CS22..CS20
+
+  // Stop the clock; CTC (WGM21) lives in TCCR2A and stays set
+  static void halt() {
+    TCCR2A = (1 << WGM21);
+    TCCR2B = 0;
+  }
+  static void run(uint8_t csBits) { TCCR2B = csBits; }
+
+  static volatile uint8_t& counter() { return TCNT2; }
+  static volatile uint8_t& compareA() { return OCR2A; }
+  static volatile uint8_t& compareB() { return OCR2B; }
+  static volatile uint8_t& mask() { return TIMSK2; }
+  static volatile uint8_t& flags() { return TIFR2; }
+  static constexpr uint8_t IE_A = 1 << OCIE2A;
+  static constexpr uint8_t IE_B = 1 << OCIE2B;
+  static constexpr uint8_t F_A = 1 << OCF2A;
+  static constexpr uint8_t F_B = 1 << OCF2B;
+};
+
+extern template class SSFDTimerCTC<SSFDTimer1Regs>;
+extern template class SSFDTimerCTC<SSFDTimer2Regs>;
+
+/**
+ * @brief Timer1 compare-A backend (16-bit CTC, prescaler from F_CPU)
+ */
+class SSFDTimer1 : public SSFDTimerCTC<SSFDTimer1Regs> {};
+
+/**
+ * @brief Timer2 compare-A backend (8-bit CTC, prescaler from F_CPU)
+ * @note Arduino tone() also uses Timer2
+ */
+class SSFDTimer2 : public SSFDTimerCTC<SSFDTimer2Regs> {};
+
+/**
+ * @brief Timer0 compare-B backend (piggybacks on the millis() timer)
+ *
+ * Timer0 is left untouched in the Arduino fast-PWM /64 configuration, so
+ * compare B fires once per overflow (F_CPU / 16384, 976 Hz at 16 MHz). The
+ * requested rate is reached with a software divider, so it is quantized
+ * and capped at that base rate. OCR0B is not modified; analogWrite() on
+ * the OC0B pin (D5) still works but shifts the tick phase.
+ */
+class SSFDTimer0B : public SSFDTimer {
+public:
+  SSFDTimer0B() : _divider(1), _countdown(1) {
+#if SSFD_STATS
+    _cyclesPerTick = 64;
+#endif
+  }
+
+  bool start(uint32_t tickHz) override;
+  void stop() override;
+  bool setRate(uint32_t tickHz) override;
+  uint8_t stretchTick(uint8_t ticks) override;
+
+  /**
+   * @brief Divide the overflow rate; called from TIMER0_COMPB_vect
+   * @return true if this tick ran dispatch()
+   */
+  inline bool tick() {
+    if (--_countdown != 0) {
+      return false;
+    }
+    _countdown = _divider;
+    dispatch();
+    return true;
+  }
+
+private:
+  static bool divider(uint32_t tickHz, uint8_t& div);
+
+  volatile uint8_t _divider;
+  volatile uint8_t _countdown;
+};
+
+#elif SSFD_ARCH_MEGAAVR
+/**
+ * @brief TCB0 periodic-interrupt backend (megaAVR-0, 16-bit, CLK_PER or
+ *        the TCA0 prescaler)
+ * @note Takes TCB0 from analogWrite() (D6 on the Nano Every). TCB has one
+ *       compare channel, so there is no dimming (setDuty())
+ */
+class SSFDTimerTCB0 : public SSFDTimer {
+public:
+  SSFDTimerTCB0() : _top(0) {}
+
+  bool start(uint32_t tickHz) override;
+  void stop() override;
+  bool setRate(uint32_t tickHz) override;
+  uint8_t stretchTick(uint8_t ticks) override;
+
+private:
+  static bool settings(uint32_t tickHz, uint8_t& clkSel, uint16_t& top,
+                       uint16_t& prescaler);
+
+  uint16_t _top; // Programmed compare value
+};
+
+#elif SSFD_ARCH_RP2040
+/**
+ * @brief Hardware-alarm backend (RP2040 1 MHz system timer)
+ *
+ * One alarm re-arms itself at an absolute target each tick, so the rate
+ * does not drift with ISR time. Dimming claims a second alarm that blanks
+ * the digit at its on-time. Both are claimed from the SDK pool on first
+ * use; the rate is quantized to whole microseconds.
+ */
+class SSFDTimerRP2040 : public SSFDTimer {
+public:
+  SSFDTimerRP2040()
+      : _alarm(-1), _blankAlarm(-1), _running(false), _period(0), _target(0),
+        _tickStart(0), _stretch(1), _duty(FULL_DUTY), _tickDuty(FULL_DUTY) {}
+
+  bool start(uint32_t tickHz) override;
+  void stop() override;
+  bool setRate(uint32_t tickHz) override;
+  uint8_t stretchTick(uint8_t ticks) override;
+  bool setDuty(uint8_t duty) override;
+  void tickDuty(uint8_t duty) override;
+
+  /**
+   * @brief One tick: re-arm, dispatch(), arm the blanking alarm (IRQ context)
+   */
+  void fire();
+
+private:
+  static bool period(uint32_t tickHz, uint32_t& us);
+
+  int8_t _alarm;          // Tick alarm (-1 = not claimed yet)
+  int8_t _blankAlarm;     // Dimming alarm (-1 = not claimed yet)
+  volatile bool _running;
+  volatile uint32_t _period; // Microseconds per tick
+  uint64_t _target;       // Start of the next tick
+  uint64_t _tickStart;    // Start of the running tick
+  uint8_t _stretch;       // Periods the running tick lasts
+  uint8_t _duty;          // Lit share of a tick
+  uint8_t _tickDuty;      // Lit share of the running tick
+};
+
+#elif SSFD_ARCH_ESP32
+/**
+ * @brief Hardware general-purpose timer backend (ESP32, 1 MHz time base)
+ * @note Uses timer 0 on arduino-esp32 2.x and the next free timer on 3.x.
+ *       The ISR is not IRAM-safe and is held off while the flash cache is
+ *       disabled. No dimming (setDuty()) or tick stretching
+ */
+class SSFDTimerESP32 : public SSFDTimer {
+public:
+  SSFDTimerESP32() : _timer(nullptr) {}
+
+  bool start(uint32_t tickHz) override;
+  void stop() override;
+  bool setRate(uint32_t tickHz) override;
+
+private:
+  static bool period(uint32_t tickHz, uint32_t& us);
+
+  hw_timer_t* _timer;
+};
+#endif
+
+/**
+ * @brief No hardware timer: the application calls dispatch() itself
+ *
+ * Call `ssfdExternalTick.dispatch()` (or `display.multiplex()` for a single
+ * display) from an existing periodic ISR. The rate passed to setRefreshRate() is recorded as
+ * the nominal frame rate but does not program any hardware. There is no
+ * timer count to timestamp, so SSFD_STATS records nothing for it.
+ */
+class SSFDExternalTick : public SSFDTimer {
+public:
+  bool start(uint32_t) override { return true; }
+  void stop() override {}
+  bool setRate(uint32_t) override { return true; }
+};
+
+#if SSFD_ARCH_AVR
+extern SSFDTimer1 ssfdTimer1;
+extern SSFDTimer2 ssfdTimer2;
+extern SSFDTimer0B ssfdTimer0B;
+#define SSFD_DEFAULT_TIMER ssfdTimer1
+#elif SSFD_ARCH_MEGAAVR
+extern SSFDTimerTCB0 ssfdTimerTCB0;
+#define SSFD_DEFAULT_TIMER ssfdTimerTCB0
+#elif SSFD_ARCH_RP2040
+extern SSFDTimerRP2040 ssfdTimerRP2040;
+#define SSFD_DEFAULT_TIMER ssfdTimerRP2040
+#elif SSFD_ARCH_ESP32
+extern SSFDTimerESP32 ssfdTimerESP32;
+#define SSFD_DEFAULT_TIMER ssfdTimerESP32
+#endif
+extern SSFDExternalTick ssfdExternalTick;
+
+#endif // SSFD_TIMER_H
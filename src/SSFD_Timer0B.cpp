@@ -0,0 +1,112 @@
+/**
+ * @file SSFD_Timer0B.cpp
+ * @brief Timer0 compare-B scheduling backend (shares the millis() timer)
+ */
+
+#include "SSFD.h"
+
+#if SSFD_ARCH_AVR
+
+SSFDTimer0B ssfdTimer0B;
+
+// Timer0 runs in Arduino fast-PWM mode, /64 prescale, 256 counts per period
+static const uint32_t TIMER0_BASE_HZ = F_CPU / 64 / 256;
+
+// ========== ISR HANDLER ==========
+/**
+ * Timer0 Compare Match B ISR (fires once per Timer0 period)
+ */
+ISR(TIMER0_COMPB_vect)
+{
+#if SSFD_STATS
+    // Fast PWM: TCNT0 free-runs 0..255, so latency is measured from OCR0B
+    uint8_t entry = TCNT0;
+    if (ssfdTimer0B.tick())
+    {
+        uint8_t exit = TCNT0;
+        ssfdTimer0B.record((uint8_t)(entry - OCR0B), (uint8_t)(exit - entry),
+                           TIFR0 & (1 << OCF0B));
+    }
+#else
+    ssfdTimer0B.tick();
+#endif
+}
+
+// ========== divider() ==========
+bool SSFDTimer0B::divider(uint32_t tickHz, uint8_t &div)
+{
+    if (tickHz == 0 || tickHz > TIMER0_BASE_HZ)
+    {
+        return false;
+    }
+
+    uint32_t d = (TIMER0_BASE_HZ + tickHz / 2) / tickHz;
+    if (d < 1)
+        d = 1;
+    if (d > 255)
+        d = 255;
+    div = (uint8_t)d;
+    return true;
+}
+
+// ========== start() ==========
+bool SSFDTimer0B::start(uint32_t tickHz)
+{
+    uint8_t div;
+    if (!divider(tickHz, div))
+    {
+        return false;
+    }
+
+    // Timer0 itself is already running for millis(); only hook compare B
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        _divider = div;
+        _countdown = div;
+        TIFR0 = (1 << OCF0B);
+        TIMSK0 |= (1 << OCIE0B);
+    }
+    return true;
+}
+
+// ========== stop() ==========
+void SSFDTimer0B::stop()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        TIMSK0 &= ~(1 << OCIE0B);
+    }
+}
+
+// ========== setRate() ==========
+bool SSFDTimer0B::setRate(uint32_t tickHz)
+{
+    uint8_t div;
+    if (!divider(tickHz, div))
+    {
+        return false;
+    }
+
+    // Takes effect when the current countdown expires
+    _divider = div;
+    return true;
+}
+
+// ========== stretchTick() ==========
+uint8_t SSFDTimer0B::stretchTick(uint8_t ticks)
+{
+    // tick() has just reloaded the countdown for the period now running
+    uint8_t fit = 255 / _divider;
+    if (ticks > fit)
+    {
+        ticks = fit;
+    }
+    if (ticks == 0)
+    {
+        ticks = 1;
+    }
+    _countdown = (uint8_t)(_divider * ticks);
+    return ticks;
+}
+
+#endif // SSFD_ARCH_AVR
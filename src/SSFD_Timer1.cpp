@@ -0,0 +1,61 @@
+/**
+ * @file SSFD_Timer1.cpp
+ * @brief Timer1 compare-A scheduling backend (ISRs and prescaler table;
+ *        the CTC logic is SSFDTimerCTC)
+ */
+
+#include "SSFD.h"
+#include "SSFD_TimerCTC.h"
+
+#if SSFD_ARCH_AVR
+
+SSFDTimer1 ssfdTimer1;
+
+// ========== ISR HANDLER ==========
+/**
+ * Timer1 Compare Match ISR
+ */
+ISR(TIMER1_COMPA_vect)
+{
+#if SSFD_STATS
+    // CTC: TCNT1 counts from 0 at the compare match, so it is the latency
+    uint16_t entry = TCNT1;
+    ssfdTimer1.dispatch();
+    uint16_t exit = TCNT1;
+    uint16_t duration = exit >= entry ? exit - entry : exit + OCR1A + 1 - entry;
+    ssfdTimer1.record(entry, duration, TIFR1 & (1 << OCF1A));
+#else
+    ssfdTimer1.dispatch();
+#endif
+}
+
+/**
+ * Timer1 Compare Match B ISR (dimming: blanks the digit mid-tick)
+ */
+ISR(TIMER1_COMPB_vect)
+{
+    ssfdTimer1.blank();
+}
+
+// ========== Prescalers ==========
+// Timer1 prescalers and their CS12..CS10 encodings
+static const uint16_t prescalers[] PROGMEM = {1, 8, 64, 256, 1024};
+static const uint8_t prescalerBits[] PROGMEM = {
+    (1 << CS10), (1 << CS11), (1 << CS11) | (1 << CS10),
+    (1 << CS12), (1 << CS12) | (1 << CS10)};
+static_assert(sizeof(prescalers) / sizeof(prescalers[0]) == SSFDTimer1Regs::PRESCALERS,
+              "SSFDTimer1Regs::PRESCALERS must match the table");
+
+uint16_t SSFDTimer1Regs::prescaler(uint8_t i)
+{
+    return pgm_read_word(&prescalers[i]);
+}
+
+uint8_t SSFDTimer1Regs::clockBits(uint8_t i)
+{
+    return pgm_read_byte(&prescalerBits[i]);
+}
+
+template class SSFDTimerCTC<SSFDTimer1Regs>;
+
+#endif // SSFD_ARCH_AVR
@@ -0,0 +1,53 @@
+/**
+ * @file SSFD_Timer2.cpp
+ * @brief Timer2 compare-A scheduling backend (ISRs and prescaler table;
+ *        the CTC logic is SSFDTimerCTC)
+ */
+
+#include "SSFD.h"
+#include "SSFD_TimerCTC.h"
+
+#if SSFD_ARCH_AVR
+
+SSFDTimer2 ssfdTimer2;
+
+// ========== ISR HANDLER ==========
+/**
+ * Timer2 Compare Match ISR
+ */
+ISR(TIMER2_COMPA_vect)
+{
+#if SSFD_STATS
+    // CTC: TCNT2 counts from 0 at the compare match, so it is the latency
+    uint8_t entry = TCNT2;
+    ssfdTimer2.dispatch();
+    uint8_t exit = TCNT2;
+    uint16_t duration = exit >= entry ? exit - entry : exit + OCR2A + 1 - entry;
+    ssfdTimer2.record(entry, duration, TIFR2 & (1 << OCF2A));
+#else
+    ssfdTimer2.dispatch();
+#endif
+}
+
+/**
+ * Timer2 Compare Match B ISR (dimming: blanks the digit mid-tick)
+ */
+ISR(TIMER2_COMPB_vect)
+{
+    ssfdTimer2.blank();
+}
+
+// ========== Prescalers ==========
+// Timer2 prescalers; CS22..CS20 encoding is the table index + 1
+static const uint16_t prescalers[] PROGMEM = {1, 8, 32, 64, 128, 256, 1024};
+static_assert(sizeof(prescalers) / sizeof(prescalers[0]) == SSFDTimer2Regs::PRESCALERS,
+              "SSFDTimer2Regs::PRESCALERS must match the table");
+
+uint16_t SSFDTimer2Regs::prescaler(uint8_t i)
+{
+    return pgm_read_word(&prescalers[i]);
+}
+
+template class SSFDTimerCTC<SSFDTimer2Regs>;
+
+#endif // SSFD_ARCH_AVR
@@ -0,0 +1,193 @@
+#ifndef SSFD_TIMER_CTC_H
+#define SSFD_TIMER_CTC_H
+
+#include "SSFD.h"
+
+/**
+ * @file SSFD_TimerCTC.h
+ * @brief SSFDTimerCTC member definitions
+ *
+ * Included only by SSFD_Timer1.cpp and SSFD_Timer2.cpp, which instantiate
+ * the template for their timer, so each backend's code still lives in (and
+ * is linked with) its own translation unit.
+ */
+
+#if SSFD_ARCH_AVR
+
+// ========== settings() ==========
+template <class Regs>
+bool SSFDTimerCTC<Regs>::settings(uint32_t tickHz, uint8_t &csBits,
+                                  Count &top, uint16_t &prescaler)
+{
+    if (tickHz == 0)
+    {
+        return false;
+    }
+
+    // Smallest prescaler whose compare value fits the counter (best resolution)
+    for (uint8_t i = 0; i < Regs::PRESCALERS; i++)
+    {
+        prescaler = Regs::prescaler(i);
+        uint32_t counts = (F_CPU / prescaler + tickHz / 2) / tickHz;
+        if (counts >= 2 && counts <= Regs::RANGE)
+        {
+            csBits = Regs::clockBits(i);
+            top = (Count)(counts - 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// ========== start() ==========
+template <class Regs>
+bool SSFDTimerCTC<Regs>::start(uint32_t tickHz)
+{
+    uint8_t csBits;
+    Count top;
+    uint16_t prescaler;
+    if (!settings(tickHz, csBits, top, prescaler))
+    {
+        return false;
+    }
+
+    // CTC mode: one interrupt per digit
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+#if SSFD_STATS
+        _cyclesPerTick = prescaler;
+#endif
+        Regs::halt();
+        Regs::counter() = 0;
+        _top = top;
+        Regs::compareA() = top;
+        Regs::run(csBits);
+        Regs::flags() = Regs::F_A;
+        Regs::mask() |= Regs::IE_A;
+        applyDuty();
+    }
+    return true;
+}
+
+// ========== stop() ==========
+template <class Regs>
+void SSFDTimerCTC<Regs>::stop()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        Regs::mask() &= ~(Regs::IE_A | Regs::IE_B);
+    }
+}
+
+// ========== setRate() ==========
+template <class Regs>
+bool SSFDTimerCTC<Regs>::setRate(uint32_t tickHz)
+{
+    uint8_t csBits;
+    Count top;
+    uint16_t prescaler;
+    if (!settings(tickHz, csBits, top, prescaler))
+    {
+        return false;
+    }
+
+    // Retune in place. If the counter is already past the new compare
+    // value, restart the period instead of letting it run to the top.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+#if SSFD_STATS
+        _cyclesPerTick = prescaler;
+#endif
+        Regs::run(csBits);
+        _top = top;
+        Regs::compareA() = top;
+        applyDuty();
+        if (Regs::counter() >= top)
+        {
+            Regs::counter() = 0;
+        }
+    }
+    return true;
+}
+
+// ========== stretchTick() ==========
+template <class Regs>
+uint8_t SSFDTimerCTC<Regs>::stretchTick(uint8_t ticks)
+{
+    // As many whole base periods as the compare register holds
+    uint32_t period = (uint32_t)_top + 1;
+    uint32_t fit = Regs::RANGE / period;
+    if (ticks > fit)
+    {
+        ticks = (uint8_t)fit;
+    }
+    if (ticks == 0)
+    {
+        ticks = 1;
+    }
+
+    // Called from the ISR right after the compare match: CTC applies the
+    // new compare value to the period already running
+    Regs::compareA() = (Count)(period * ticks - 1);
+    return ticks;
+}
+
+// ========== setDuty() ==========
+template <class Regs>
+bool SSFDTimerCTC<Regs>::setDuty(uint8_t duty)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        _duty = duty;
+        if (Regs::mask() & Regs::IE_A)
+        {
+            applyDuty();
+        }
+    }
+    return true;
+}
+
+// ========== tickDuty() ==========
+template <class Regs>
+void SSFDTimerCTC<Regs>::tickDuty(uint8_t duty)
+{
+    if (duty == FULL_DUTY)
+    {
+        Regs::mask() &= ~Regs::IE_B;
+        return;
+    }
+
+    // A match of the old compare value earlier in this tick must not blank
+    // the digit just driven; a new value the counter has already passed
+    // will not match, so blank here instead
+    Count match = dutyMatch(duty);
+    Regs::compareB() = match;
+    Regs::flags() = Regs::F_B;
+    Regs::mask() |= Regs::IE_B;
+    if (Regs::counter() >= match)
+    {
+        blank();
+    }
+}
+
+// ========== applyDuty() ==========
+template <class Regs>
+void SSFDTimerCTC<Regs>::applyDuty()
+{
+    // Full brightness needs no blanking, and no second interrupt
+    if (_duty == FULL_DUTY)
+    {
+        Regs::mask() &= ~Regs::IE_B;
+        return;
+    }
+
+    // Compare B at duty/256 of the period; it follows a retuned period
+    Regs::compareB() = dutyMatch(_duty);
+    Regs::flags() = Regs::F_B;
+    Regs::mask() |= Regs::IE_B;
+}
+
+#endif // SSFD_ARCH_AVR
+
+#endif // SSFD_TIMER_CTC_H
@@ -0,0 +1,126 @@
+/**
+ * @file SSFD_TimerESP32.cpp
+ * @brief ESP32 hardware-timer scheduling backend
+ */
+
+#include "SSFD.h"
+
+#if SSFD_ARCH_ESP32
+
+// arduino-esp32 3.x takes a tick frequency instead of timer number and
+// divider, and replaced timerAlarmWrite() / timerAlarmEnable()
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+#define SSFD_ESP32_TIMER_API 3
+#else
+#define SSFD_ESP32_TIMER_API 2
+#endif
+
+static const uint32_t TIMER_HZ = 1000000UL; // 1 us time base
+
+SSFDTimerESP32 ssfdTimerESP32;
+
+// ========== ISR HANDLER ==========
+/**
+ * Timer alarm ISR (auto-reload); its hot path is in IRAM (SSFD_ISR_ATTR)
+ */
+static void IRAM_ATTR onTimer()
+{
+    ssfdTimerESP32.dispatch();
+}
+
+// ========== period() ==========
+bool SSFDTimerESP32::period(uint32_t tickHz, uint32_t &us)
+{
+    if (tickHz == 0)
+    {
+        return false;
+    }
+
+    // Whole microseconds, at least two per tick
+    us = (TIMER_HZ + tickHz / 2) / tickHz;
+    return us >= 2;
+}
+
+// ========== start() ==========
+bool SSFDTimerESP32::start(uint32_t tickHz)
+{
+    uint32_t us;
+    if (!period(tickHz, us))
+    {
+        return false;
+    }
+
+    // The timer is allocated once and kept; its interrupt is attached on the
+    // calling core
+    if (_timer == nullptr)
+    {
+#if SSFD_ESP32_TIMER_API >= 3
+        _timer = timerBegin(TIMER_HZ);
+#else
+        _timer = timerBegin(0, APB_CLK_FREQ / TIMER_HZ, true);
+#endif
+        if (_timer == nullptr)
+        {
+            return false;
+        }
+#if SSFD_ESP32_TIMER_API >= 3
+        timerAttachInterrupt(_timer, &onTimer);
+#else
+        timerAttachInterrupt(_timer, &onTimer, true);
+#endif
+    }
+
+#if SSFD_ESP32_TIMER_API >= 3
+    timerAlarm(_timer, us, true, 0);
+    timerRestart(_timer);
+    timerStart(_timer);
+#else
+    timerAlarmWrite(_timer, us, true);
+    timerWrite(_timer, 0);
+    timerAlarmEnable(_timer);
+#endif
+    return true;
+}
+
+// ========== stop() ==========
+void SSFDTimerESP32::stop()
+{
+    if (_timer == nullptr)
+    {
+        return;
+    }
+#if SSFD_ESP32_TIMER_API >= 3
+    timerStop(_timer);
+#else
+    timerAlarmDisable(_timer);
+#endif
+}
+
+// ========== setRate() ==========
+bool SSFDTimerESP32::setRate(uint32_t tickHz)
+{
+    uint32_t us;
+    if (!period(tickHz, us))
+    {
+        return false;
+    }
+    if (_timer == nullptr)
+    {
+        return true; // start() programs the rate
+    }
+
+    // Retune in place; a count already past the new alarm would only match
+    // after a 64-bit wrap, so restart the period instead
+#if SSFD_ESP32_TIMER_API >= 3
+    timerAlarm(_timer, us, true, 0);
+#else
+    timerAlarmWrite(_timer, us, true);
+#endif
+    if (timerRead(_timer) >= us)
+    {
+        timerWrite(_timer, 0);
+    }
+    return true;
+}
+
+#endif // SSFD_ARCH_ESP32
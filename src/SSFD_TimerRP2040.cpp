@@ -0,0 +1,196 @@
+/**
+ * @file SSFD_TimerRP2040.cpp
+ * @brief RP2040 hardware-alarm scheduling backend
+ */
+
+#include "SSFD.h"
+
+#if SSFD_ARCH_RP2040
+
+#include <hardware/timer.h>
+
+SSFDTimerRP2040 ssfdTimerRP2040;
+
+// ========== ALARM HANDLERS ==========
+/**
+ * Tick alarm (timer IRQ): one multiplex step, then the next target
+ */
+static void onTickAlarm(uint alarm)
+{
+    (void)alarm;
+    ssfdTimerRP2040.fire();
+}
+
+/**
+ * Dimming alarm: blanks the digit at the end of its on-time
+ */
+static void onBlankAlarm(uint alarm)
+{
+    (void)alarm;
+    ssfdTimerRP2040.blank();
+}
+
+/**
+ * Claim a free alarm from the SDK pool for a callback
+ * @return false if every alarm is taken
+ */
+static bool claimAlarm(int8_t &slot, hardware_alarm_callback_t callback)
+{
+    if (slot >= 0)
+    {
+        return true;
+    }
+    int alarm = hardware_alarm_claim_unused(false);
+    if (alarm < 0)
+    {
+        return false;
+    }
+    slot = (int8_t)alarm;
+    hardware_alarm_set_callback((uint)alarm, callback);
+    return true;
+}
+
+// ========== period() ==========
+bool SSFDTimerRP2040::period(uint32_t tickHz, uint32_t &us)
+{
+    if (tickHz == 0)
+    {
+        return false;
+    }
+
+    // 1 MHz timer: whole microseconds, at least two per tick
+    us = (1000000UL + tickHz / 2) / tickHz;
+    return us >= 2;
+}
+
+// ========== start() ==========
+bool SSFDTimerRP2040::start(uint32_t tickHz)
+{
+    uint32_t us;
+    if (!period(tickHz, us) || !claimAlarm(_alarm, onTickAlarm))
+    {
+        return false;
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        _period = us;
+        _stretch = 1;
+        _running = true;
+        _tickStart = time_us_64();
+        _target = _tickStart + us;
+        hardware_alarm_set_target((uint)_alarm, from_us_since_boot(_target));
+    }
+    return true;
+}
+
+// ========== stop() ==========
+void SSFDTimerRP2040::stop()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        _running = false;
+        if (_alarm >= 0)
+        {
+            hardware_alarm_cancel((uint)_alarm);
+        }
+        if (_blankAlarm >= 0)
+        {
+            hardware_alarm_cancel((uint)_blankAlarm);
+        }
+    }
+}
+
+// ========== setRate() ==========
+bool SSFDTimerRP2040::setRate(uint32_t tickHz)
+{
+    uint32_t us;
+    if (!period(tickHz, us))
+    {
+        return false;
+    }
+
+    // The running tick ends early if the new period is shorter, as a CTC
+    // timer does when its compare value drops
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        _period = us;
+        uint64_t next = _tickStart + us;
+        if (_running && next < _target)
+        {
+            _target = next;
+            if (hardware_alarm_set_target((uint)_alarm, from_us_since_boot(next)))
+            {
+                _target = time_us_64() + 1;
+                hardware_alarm_set_target((uint)_alarm, from_us_since_boot(_target));
+            }
+        }
+    }
+    return true;
+}
+
+// ========== stretchTick() ==========
+uint8_t SSFDTimerRP2040::stretchTick(uint8_t ticks)
+{
+    // fire() sets the next target after dispatch(), so this only scales it
+    _stretch = ticks == 0 ? 1 : ticks;
+    return _stretch;
+}
+
+// ========== setDuty() ==========
+bool SSFDTimerRP2040::setDuty(uint8_t duty)
+{
+    if (duty != FULL_DUTY && !claimAlarm(_blankAlarm, onBlankAlarm))
+    {
+        return false;
+    }
+    _duty = duty; // Taken up by the next tick
+    return true;
+}
+
+// ========== tickDuty() ==========
+void SSFDTimerRP2040::tickDuty(uint8_t duty)
+{
+    _tickDuty = duty;
+}
+
+// ========== fire() ==========
+void SSFDTimerRP2040::fire()
+{
+    if (!_running)
+    {
+        return;
+    }
+
+    _tickStart = _target;
+    _stretch = 1;
+    _tickDuty = _duty;
+    dispatch();
+
+    // A blank stop inside dispatch() stopped the timer
+    if (!_running)
+    {
+        return;
+    }
+
+    // Absolute targets: time spent in dispatch() does not add to the period
+    _target += (uint64_t)_period * _stretch;
+    if (hardware_alarm_set_target((uint)_alarm, from_us_since_boot(_target)))
+    {
+        // Fell behind by a whole period (e.g. a flash write): resynchronize
+        _target = time_us_64() + _period;
+        hardware_alarm_set_target((uint)_alarm, from_us_since_boot(_target));
+    }
+
+    // Dimming: blank at the end of the on-time, at once if it has passed
+    if (_tickDuty != FULL_DUTY && _blankAlarm >= 0)
+    {
+        uint64_t off = _tickStart + ((uint64_t)_period * _tickDuty >> 8);
+        if (hardware_alarm_set_target((uint)_blankAlarm, from_us_since_boot(off)))
+        {
+            blank();
+        }
+    }
+}
+
+#endif // SSFD_ARCH_RP2040
@@ -0,0 +1,164 @@
+/**
+ * @file SSFD_TimerTCB0.cpp
+ * @brief megaAVR-0 TCB0 periodic-interrupt scheduling backend
+ */
+
+#include "SSFD.h"
+
+#if SSFD_ARCH_MEGAAVR
+
+SSFDTimerTCB0 ssfdTimerTCB0;
+
+// ========== ISR HANDLER ==========
+/**
+ * TCB0 capture/compare ISR (periodic interrupt mode)
+ */
+ISR(TCB0_INT_vect)
+{
+    // Not cleared by hardware in this mode; clearing first makes a flag
+    // set again at exit an overrun
+    TCB0.INTFLAGS = TCB_CAPT_bm;
+#if SSFD_STATS
+    // The counter restarts from 0 at the compare match, so it is the latency
+    uint16_t entry = TCB0.CNT;
+    ssfdTimerTCB0.dispatch();
+    uint16_t exit = TCB0.CNT;
+    uint16_t duration = exit >= entry ? exit - entry : exit + TCB0.CCMP + 1 - entry;
+    ssfdTimerTCB0.record(entry, duration, TCB0.INTFLAGS & TCB_CAPT_bm);
+#else
+    ssfdTimerTCB0.dispatch();
+#endif
+}
+
+// ========== settings() ==========
+bool SSFDTimerTCB0::settings(uint32_t tickHz, uint8_t &clkSel, uint16_t &top,
+                             uint16_t &prescaler)
+{
+    // TCA0 prescaler by its CLKSEL encoding (the core runs TCA0 for PWM)
+    static const uint16_t tcaPrescalers[] PROGMEM = {1, 2, 4, 8, 16, 64, 256, 1024};
+
+    if (tickHz == 0)
+    {
+        return false;
+    }
+
+    // CLK_PER / 1 and / 2, then TCA0's clock for slow rates if it runs
+    uint16_t prescalers[] = {1, 2, 0};
+    const uint8_t clkSels[] = {TCB_CLKSEL_CLKDIV1_gc, TCB_CLKSEL_CLKDIV2_gc,
+                               TCB_CLKSEL_CLKTCA_gc};
+    if (TCA0.SINGLE.CTRLA & TCA_SINGLE_ENABLE_bm)
+    {
+        uint8_t index = (TCA0.SINGLE.CTRLA & TCA_SINGLE_CLKSEL_gm) >> TCA_SINGLE_CLKSEL_gp;
+        prescalers[2] = pgm_read_word(&tcaPrescalers[index]);
+    }
+
+    // Smallest prescaler whose compare value fits 16 bits (best resolution)
+    for (uint8_t i = 0; i < sizeof(prescalers) / sizeof(prescalers[0]); i++)
+    {
+        prescaler = prescalers[i];
+        if (prescaler == 0)
+        {
+            continue;
+        }
+        uint32_t counts = (F_CPU / prescaler + tickHz / 2) / tickHz;
+        if (counts >= 2 && counts <= 65536UL)
+        {
+            clkSel = clkSels[i];
+            top = (uint16_t)(counts - 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// ========== start() ==========
+bool SSFDTimerTCB0::start(uint32_t tickHz)
+{
+    uint8_t clkSel;
+    uint16_t top;
+    uint16_t prescaler;
+    if (!settings(tickHz, clkSel, top, prescaler))
+    {
+        return false;
+    }
+
+    // Periodic interrupt mode: counts 0..CCMP, one interrupt per digit
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+#if SSFD_STATS
+        _cyclesPerTick = prescaler;
+#endif
+        TCB0.CTRLA = 0;
+        TCB0.CTRLB = TCB_CNTMODE_INT_gc;
+        TCB0.CNT = 0;
+        _top = top;
+        TCB0.CCMP = top;
+        TCB0.INTFLAGS = TCB_CAPT_bm;
+        TCB0.INTCTRL = TCB_CAPT_bm;
+        TCB0.CTRLA = clkSel | TCB_ENABLE_bm;
+    }
+    return true;
+}
+
+// ========== stop() ==========
+void SSFDTimerTCB0::stop()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        TCB0.INTCTRL = 0;
+        TCB0.CTRLA = 0;
+    }
+}
+
+// ========== setRate() ==========
+bool SSFDTimerTCB0::setRate(uint32_t tickHz)
+{
+    uint8_t clkSel;
+    uint16_t top;
+    uint16_t prescaler;
+    if (!settings(tickHz, clkSel, top, prescaler))
+    {
+        return false;
+    }
+
+    // Retune in place. If the counter is already past the new compare
+    // value, restart the period instead of letting it run to 0xFFFF.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+#if SSFD_STATS
+        _cyclesPerTick = prescaler;
+#endif
+        TCB0.CTRLA = clkSel | TCB_ENABLE_bm;
+        _top = top;
+        TCB0.CCMP = top;
+        if (TCB0.CNT >= top)
+        {
+            TCB0.CNT = 0;
+        }
+    }
+    return true;
+}
+
+// ========== stretchTick() ==========
+uint8_t SSFDTimerTCB0::stretchTick(uint8_t ticks)
+{
+    // As many whole base periods as the compare register holds
+    uint32_t period = (uint32_t)_top + 1;
+    uint32_t fit = 65536UL / period;
+    if (ticks > fit)
+    {
+        ticks = (uint8_t)fit;
+    }
+    if (ticks == 0)
+    {
+        ticks = 1;
+    }
+
+    // Called from the ISR right after the match: the period already running
+    // ends at the new compare value
+    TCB0.CCMP = (uint16_t)(period * ticks - 1);
+    return ticks;
+}
+
+#endif // SSFD_ARCH_MEGAAVR
@@ -0,0 +1,61 @@
+/**
+ * @file bench_host.cpp
+ * @brief Host microbenchmarks for the SSFD formatters
+ *
+ * Times each setter against the shim with std::chrono and prints one
+ * machine-readable line per case:
+ * ```
+ * HOSTBENCH,<case>,<ns_per_call>
+ * ```
+ * Usage: `ssfd_bench [iterations]` (default 1000000). Host timings track
+ * relative regressions only; use examples/04_Benchmark for AVR cycles.
+ */
+
+#include "capture_display.h"
+#include <chrono>
+#include <stdlib.h>
+
+static CaptureDisplay display;
+static volatile uint16_t benchValue = 1234;
+static volatile float benchFloats[2] = {12.34f, 12.35f};
+static const char *const benchTexts[2] = {"HELP", "HELd"};
+static uint8_t benchPatterns[2][4] = {{0x6E, 0x9E, 0x1C, 0xCE}, {0x6E, 0x9E, 0x1C, 0x7A}};
+
+template <typename Fn>
+static void run(const char *name, unsigned long iterations, Fn fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        fn(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    printf("HOSTBENCH,%s,%.2f\n", name, ns);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000UL;
+    if (iterations == 0)
+    {
+        iterations = 1;
+    }
+
+    display.beginAndSync();
+    run("setNumber", iterations, [](unsigned long i) { display.setNumber((uint16_t)(i % 10000)); });
+    run("setFloat", iterations, [](unsigned long i) { display.setFloat(benchFloats[i & 1]); });
+    run("setFixed", iterations, [](unsigned long i) { display.setFixed((int32_t)(i % 100000), -2); });
+    run("setInt", iterations, [](unsigned long i) { display.setInt((int16_t)(i % 10999) - 999); });
+    run("setHex", iterations, [](unsigned long i) { display.setHex((uint16_t)i); });
+    run("setText", iterations, [](unsigned long i) { display.setText(benchTexts[i & 1]); });
+    run("setSegments", iterations, [](unsigned long i) { display.setSegments(benchPatterns[i & 1]); });
+    // clear() of a lit frame; the figure includes re-lighting it
+    run("clear", iterations, [](unsigned long i) {
+        display.clear();
+        display.setSegments(benchPatterns[i & 1]);
+    });
+    run("setNumber_repeat", iterations, [](unsigned long) { display.setNumber(benchValue); });
+    run("multiplex", iterations, [](unsigned long) { display.multiplex(); });
+    return 0;
+}
@@ -0,0 +1,156 @@
+#ifndef SSFD_CAPTURE_DISPLAY_H
+#define SSFD_CAPTURE_DISPLAY_H
+
+/**
+ * @file capture_display.h
+ * @brief Test driver that records what the multiplexer lights
+ */
+
+#include "SSFD.h"
+#include "ssfd_test.h"
+#include <string>
+
+/**
+ * @brief SevenSegmentBase whose drive() captures one scan into `lit`
+ *
+ * After begin(ssfdExternalTick) call sync() once so that each scan() runs
+ * digit 0..getDigitCount()-1 in order and starts on the frame boundary.
+ */
+class CaptureDisplay : public SevenSegmentBase {
+public:
+  uint8_t lit[MAX_DIGITS] = {};  // Pattern shown per digit in the last scan
+  unsigned maskErrors = 0;       // drive() lit a digit other than the scanned one
+  unsigned drives = 0;
+  unsigned litTicks[MAX_DIGITS] = {}; // drive() calls that lit digit N
+
+  explicit CaptureDisplay(uint8_t digits = NUM_DIGITS) : SevenSegmentBase(digits) {}
+
+  Error beginAndSync() {
+    Error err = begin(ssfdExternalTick);
+    sync();
+    return err;
+  }
+
+  /**
+   * @brief Tick until the next tick is digit 0
+   */
+  void sync() {
+    uint8_t digits = getDigitCount();
+    for (uint8_t i = 0; i < digits; i++) {
+      _tick = (uint8_t)((i + 1) % digits);
+      multiplex();
+      if (_lastMask == (1 << (digits - 1))) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief Run one full frame (getDigitCount() ticks) and capture it
+   */
+  void scan() {
+    for (uint8_t d = 0; d < getDigitCount(); d++) {
+      _tick = d;
+      multiplex();
+    }
+  }
+
+  /**
+   * @brief Run several frames; `lit` holds the last one
+   */
+  void scan(unsigned frames) {
+    while (frames--) {
+      scan();
+    }
+  }
+
+  /**
+   * @brief Zero the drive() counters
+   */
+  void resetCounts() {
+    drives = 0;
+    maskErrors = 0;
+    for (uint8_t d = 0; d < MAX_DIGITS; d++) {
+      litTicks[d] = 0;
+    }
+  }
+
+  uint8_t lastMask() const { return _lastMask; }
+  uint8_t lastSegments() const { return _lastSegments; }
+
+protected:
+  Error beginOutput() override { return Error::OK; }
+
+  void drive(uint8_t segments, uint8_t digitMask) override {
+    drives++;
+    _lastMask = digitMask;
+    _lastSegments = segments;
+    for (uint8_t d = 0; d < MAX_DIGITS; d++) {
+      if (digitMask == (1 << d)) {
+        litTicks[d]++;
+      }
+    }
+    if (digitMask != 0 && digitMask != (1 << _tick)) {
+      maskErrors++;
+    }
+    lit[_tick] = digitMask ? segments : 0;
+  }
+
+private:
+  uint8_t _tick = 0;
+  uint8_t _lastMask = 0;
+  uint8_t _lastSegments = 0;
+};
+
+/**
+ * @brief Font glyph of c (0 if none)
+ * @note Builds without SSFD_TEXT have no ssfdFont: numerals and '-' only
+ */
+inline uint8_t glyphOf(char c) {
+#if SSFD_TEXT
+  return pgm_read_byte(&ssfdFont[(uint8_t)c]);
+#else
+  static const char chars[] = "0123456789ABCDEF-";
+  static const uint8_t glyphs[] = {0xFC, 0x60, 0xDA, 0xF2, 0x66, 0xB6, 0xBE, 0xE0, 0xFE,
+                                   0xF6, 0xEE, 0x3E, 0x9C, 0x7A, 0x9E, 0x8E, 0x02};
+  for (uint8_t i = 0; chars[i]; i++) {
+    if (chars[i] == c) {
+      return glyphs[i];
+    }
+  }
+  return 0;
+#endif
+}
+
+/**
+ * @brief Decode patterns back to text ('.' follows a digit with its DP lit)
+ *
+ * Glyphs shared by several characters decode to the first of: digits,
+ * space, dash, uppercase, lowercase, punctuation ('?' if unknown).
+ */
+inline std::string render(const uint8_t* patterns, uint8_t count = SevenSegmentBase::NUM_DIGITS) {
+  static const char order[] =
+      "0123456789 -ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz_=?'\"()[]/\\^`|~*!$\x7F";
+  std::string out;
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t glyph = patterns[i] & 0xFE;
+    char c = '?';
+    for (const char* p = order; *p; p++) {
+      if (glyphOf(*p) == glyph) {
+        c = *p;
+        break;
+      }
+    }
+    out += c;
+    if (patterns[i] & 0x01) {
+      out += '.';
+    }
+  }
+  return out;
+}
+
+inline std::string render(const CaptureDisplay& display) {
+  return render(display.lit, display.getDigitCount());
+}
+
+#endif // SSFD_CAPTURE_DISPLAY_H
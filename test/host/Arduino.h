@@ -0,0 +1,90 @@
+#ifndef SSFD_HOST_ARDUINO_H
+#define SSFD_HOST_ARDUINO_H
+
+/**
+ * @file Arduino.h
+ * @brief Host shim for the Arduino core (unit tests and benchmarks only)
+ *
+ * Provides just enough of the Arduino API for the SSFD sources to compile
+ * and run on a desktop compiler. Pin writes, the millisecond clock and the
+ * SPI data register are recorded in the `shim` namespace so tests can
+ * inspect what the library did.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "Print.h"
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+// ========== PIN MAP (ATmega328P) ==========
+#define NOT_A_PIN 0
+#define PB 2
+#define PC 3
+#define PD 4
+#define SS 10
+#define MOSI 11
+#define MISO 12
+#define SCK 13
+#define A0 14
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+uint8_t digitalPinToPort(uint8_t pin);
+uint8_t digitalPinToBitMask(uint8_t pin);
+volatile uint8_t* portOutputRegister(uint8_t port);
+
+// ========== TIME ==========
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+// ========== SERIAL ==========
+/**
+ * @brief Serial port stand-in that prints to stdout
+ */
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long) {}
+  void flush() {}
+  size_t write(uint8_t c) override;
+  using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+// ========== TEST CONTROLS ==========
+namespace shim {
+
+static constexpr uint8_t NUM_PINS = 20;
+static constexpr size_t SPI_LOG_SIZE = 256;
+
+extern uint8_t pinLevel[NUM_PINS]; // Last digitalWrite() per pin
+extern uint8_t pinDirection[NUM_PINS];
+extern uint8_t spiLog[SPI_LOG_SIZE]; // Bytes written to SPDR, in order
+extern size_t spiLogLength;
+
+/**
+ * @brief Clear registers, pin state, the SPI log and the clock
+ */
+void reset();
+
+/**
+ * @brief Advance the millis()/micros() clock
+ */
+void advanceMillis(unsigned long ms);
+
+} // namespace shim
+
+#endif // SSFD_HOST_ARDUINO_H
@@ -0,0 +1,186 @@
+/**
+ * @file ArduinoShim.cpp
+ * @brief Host implementation of the Arduino/AVR shim
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+
+// ========== REGISTERS ==========
+volatile uint8_t TCCR0A, TCCR0B, TCNT0, OCR0A, OCR0B, TIMSK0, TIFR0;
+volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+volatile uint16_t TCNT1, OCR1A, OCR1B;
+volatile uint8_t TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B, TIMSK2, TIFR2;
+volatile uint8_t PORTB, PORTC, PORTD, DDRB, DDRC, DDRD;
+volatile uint8_t SREG = 0x80;
+volatile uint8_t SPCR;
+ShimSpiStatus SPSR;
+ShimSpiData SPDR;
+
+HardwareSerial Serial;
+
+namespace shim {
+
+uint8_t pinLevel[NUM_PINS];
+uint8_t pinDirection[NUM_PINS];
+uint8_t spiLog[SPI_LOG_SIZE];
+size_t spiLogLength;
+
+static unsigned long nowMs;
+
+// ========== reset() ==========
+void reset()
+{
+    TCCR0A = TCCR0B = TCNT0 = OCR0A = OCR0B = TIMSK0 = TIFR0 = 0;
+    TCCR1A = TCCR1B = TIMSK1 = TIFR1 = 0;
+    TCNT1 = OCR1A = OCR1B = 0;
+    TCCR2A = TCCR2B = TCNT2 = OCR2A = OCR2B = TIMSK2 = TIFR2 = 0;
+    PORTB = PORTC = PORTD = DDRB = DDRC = DDRD = 0;
+    SREG = 0x80;
+    SPCR = 0;
+    SPSR = 0;
+    SPDR.value = 0;
+    memset(pinLevel, 0, sizeof(pinLevel));
+    memset(pinDirection, 0, sizeof(pinDirection));
+    spiLogLength = 0;
+    nowMs = 0;
+}
+
+// ========== advanceMillis() ==========
+void advanceMillis(unsigned long ms)
+{
+    nowMs += ms;
+}
+
+} // namespace shim
+
+// ========== SPDR ==========
+ShimSpiData &ShimSpiData::operator=(uint8_t v)
+{
+    value = v;
+    if (shim::spiLogLength < shim::SPI_LOG_SIZE)
+    {
+        shim::spiLog[shim::spiLogLength++] = v;
+    }
+    return *this;
+}
+
+// ========== PINS ==========
+uint8_t digitalPinToPort(uint8_t pin)
+{
+    return pin < 8 ? PD : pin < 14 ? PB : pin < 20 ? PC : NOT_A_PIN;
+}
+
+uint8_t digitalPinToBitMask(uint8_t pin)
+{
+    return (uint8_t)(1 << (pin < 8 ? pin : pin < 14 ? pin - 8 : pin - 14));
+}
+
+volatile uint8_t *portOutputRegister(uint8_t port)
+{
+    return port == PB ? &PORTB : port == PC ? &PORTC : port == PD ? &PORTD : nullptr;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < shim::NUM_PINS)
+    {
+        shim::pinDirection[pin] = mode;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin >= shim::NUM_PINS)
+    {
+        return;
+    }
+    shim::pinLevel[pin] = value ? HIGH : LOW;
+
+    // Mirror into the port register, as the real core does
+    volatile uint8_t *reg = portOutputRegister(digitalPinToPort(pin));
+    if (value)
+    {
+        *reg |= digitalPinToBitMask(pin);
+    }
+    else
+    {
+        *reg &= (uint8_t)~digitalPinToBitMask(pin);
+    }
+}
+
+// ========== TIME ==========
+unsigned long millis()
+{
+    return shim::nowMs;
+}
+
+unsigned long micros()
+{
+    return shim::nowMs * 1000UL;
+}
+
+void delay(unsigned long ms)
+{
+    shim::advanceMillis(ms);
+}
+
+// ========== PRINT ==========
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+    {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::write(const char *str)
+{
+    return str == nullptr ? 0 : write((const uint8_t *)str, strlen(str));
+}
+
+size_t Print::print(const __FlashStringHelper *str)
+{
+    return write(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+    char buf[8 * sizeof(long) + 1];
+    char *p = &buf[sizeof(buf) - 1];
+    *p = '\0';
+    if (base < 2)
+    {
+        base = 10;
+    }
+    do
+    {
+        unsigned long digit = n % base;
+        *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        n /= base;
+    } while (n);
+    return write(p);
+}
+
+size_t Print::print(long n, int base)
+{
+    if (base == 10 && n < 0)
+    {
+        return write((uint8_t)'-') + print((unsigned long)0 - (unsigned long)n, 10);
+    }
+    return print((unsigned long)n, base);
+}
+
+size_t Print::print(double n, int digits)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", digits, n);
+    return write(buf);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
@@ -0,0 +1,39 @@
+#ifndef SSFD_HOST_PRINT_H
+#define SSFD_HOST_PRINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <avr/pgmspace.h>
+
+#define DEC 10
+#define HEX 16
+
+/**
+ * @brief Subset of the Arduino Print class (text and integer output)
+ */
+class Print {
+public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* str);
+
+  size_t print(const char* str) { return write(str); }
+  size_t print(const __FlashStringHelper* str);
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int n, int base = DEC) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(double n, int digits = 2);
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(T value) {
+    size_t n = print(value);
+    return n + println();
+  }
+};
+
+#endif // SSFD_HOST_PRINT_H
@@ -0,0 +1,12 @@
+#ifndef SSFD_HOST_AVR_INTERRUPT_H
+#define SSFD_HOST_AVR_INTERRUPT_H
+
+#include <avr/io.h>
+
+// Vectors become plain functions; tests call them to simulate a tick
+#define ISR(vector) extern "C" void vector(void); extern "C" void vector(void)
+
+inline void cli() { SREG &= (uint8_t)~0x80; }
+inline void sei() { SREG |= 0x80; }
+
+#endif // SSFD_HOST_AVR_INTERRUPT_H
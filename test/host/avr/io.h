@@ -0,0 +1,78 @@
+#ifndef SSFD_HOST_AVR_IO_H
+#define SSFD_HOST_AVR_IO_H
+
+/**
+ * @file io.h
+ * @brief ATmega328P registers used by SSFD, as plain host variables
+ */
+
+#include <stdint.h>
+
+#ifndef __AVR_ATmega328P__
+#define __AVR_ATmega328P__ 1
+#endif
+
+// ========== TIMERS ==========
+extern volatile uint8_t TCCR0A, TCCR0B, TCNT0, OCR0A, OCR0B, TIMSK0, TIFR0;
+extern volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+extern volatile uint16_t TCNT1, OCR1A, OCR1B;
+extern volatile uint8_t TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B, TIMSK2, TIFR2;
+
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define WGM12 3
+#define OCIE1A 1
+#define OCIE1B 2
+#define OCF1A 1
+#define OCF1B 2
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define WGM21 1
+#define OCIE2A 1
+#define OCIE2B 2
+#define OCF2A 1
+#define OCF2B 2
+#define OCIE0B 2
+#define OCF0B 2
+
+// ========== PORTS ==========
+extern volatile uint8_t PORTB, PORTC, PORTD, DDRB, DDRC, DDRD;
+extern volatile uint8_t SREG;
+
+// ========== SPI ==========
+/**
+ * @brief SPSR stand-in: transfers complete instantly, so SPIF always reads set
+ */
+struct ShimSpiStatus {
+  uint8_t value;
+  operator uint8_t() const { return (uint8_t)(value | 0x80); }
+  ShimSpiStatus& operator=(uint8_t v) { value = v; return *this; }
+};
+
+/**
+ * @brief SPDR stand-in: every write is appended to shim::spiLog
+ */
+struct ShimSpiData {
+  uint8_t value;
+  operator uint8_t() const { return value; }
+  ShimSpiData& operator=(uint8_t v);
+};
+
+extern volatile uint8_t SPCR;
+extern ShimSpiStatus SPSR;
+extern ShimSpiData SPDR;
+
+#define SPR0 0
+#define SPR1 1
+#define CPHA 2
+#define CPOL 3
+#define MSTR 4
+#define DORD 5
+#define SPE 6
+#define SPIE 7
+#define SPI2X 0
+#define SPIF 7
+
+#endif // SSFD_HOST_AVR_IO_H
@@ -0,0 +1,28 @@
+#ifndef SSFD_HOST_AVR_PGMSPACE_H
+#define SSFD_HOST_AVR_PGMSPACE_H
+
+/**
+ * @file pgmspace.h
+ * @brief Flash access on the host: PROGMEM data is ordinary memory
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+typedef const char* PGM_P;
+
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_float(addr) (*(const float*)(addr))
+#define pgm_read_ptr(addr) (*(void* const*)(addr))
+
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(PSTR(s)))
+
+#endif // SSFD_HOST_AVR_PGMSPACE_H
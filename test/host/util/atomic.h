@@ -0,0 +1,24 @@
+#ifndef SSFD_HOST_UTIL_ATOMIC_H
+#define SSFD_HOST_UTIL_ATOMIC_H
+
+#include <avr/io.h>
+
+/**
+ * @file atomic.h
+ * @brief ATOMIC_BLOCK on the host: single-threaded, only SREG.I is modeled
+ */
+
+static inline uint8_t ssfdShimAtomicEnter() {
+  uint8_t saved = SREG;
+  SREG &= (uint8_t)~0x80;
+  return saved;
+}
+
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_FORCEON 1
+#define ATOMIC_BLOCK(type)                                                   \
+  for (uint8_t ssfdSreg = ssfdShimAtomicEnter(), ssfdOnce = 1; ssfdOnce;     \
+       SREG = (type) == ATOMIC_FORCEON ? (uint8_t)(ssfdSreg | 0x80) : ssfdSreg, \
+               ssfdOnce = 0)
+
+#endif // SSFD_HOST_UTIL_ATOMIC_H
@@ -0,0 +1,77 @@
+#ifndef SSFD_TEST_H
+#define SSFD_TEST_H
+
+/**
+ * @file ssfd_test.h
+ * @brief Minimal self-registering unit test harness for the host build
+ *
+ * ```cpp
+ * TEST(setNumberPadsWithBlanks) {
+ *   CHECK_EQ(render(display), std::string("  42"));
+ * }
+ * ```
+ * Each test binary links test_main.cpp, which runs every registered test
+ * and returns non-zero if any check failed.
+ */
+
+#include <stdio.h>
+#include <string>
+
+namespace ssfdtest {
+
+typedef void (*TestFn)();
+
+struct TestCase {
+  const char* name;
+  TestFn fn;
+  TestCase* next;
+};
+
+/**
+ * @brief Add a test to the global list (used by TEST())
+ */
+struct Registrar {
+  Registrar(TestCase* test);
+};
+
+/**
+ * @brief Record a failed check for the running test
+ */
+void fail(const char* file, int line, const std::string& message);
+
+/**
+ * @brief Run all registered tests
+ * @return Number of failed tests
+ */
+int runAll();
+
+template <typename T>
+std::string show(const T& value) { return std::to_string(value); }
+inline std::string show(const std::string& value) { return "\"" + value + "\""; }
+inline std::string show(const char* value) { return show(std::string(value)); }
+inline std::string show(bool value) { return value ? "true" : "false"; }
+
+} // namespace ssfdtest
+
+#define TEST(name)                                                     \
+  static void name();                                                  \
+  static ssfdtest::TestCase name##_case = {#name, name, nullptr};      \
+  static ssfdtest::Registrar name##_registrar(&name##_case);           \
+  static void name()
+
+#define CHECK(cond)                                                    \
+  do {                                                                 \
+    if (!(cond)) ssfdtest::fail(__FILE__, __LINE__, "CHECK(" #cond ")"); \
+  } while (0)
+
+#define CHECK_EQ(actual, expected)                                     \
+  do {                                                                 \
+    auto ssfdActual = (actual);                                        \
+    auto ssfdExpected = (expected);                                    \
+    if (!(ssfdActual == ssfdExpected))                                 \
+      ssfdtest::fail(__FILE__, __LINE__,                               \
+                     #actual " == " + ssfdtest::show(ssfdActual) +     \
+                         ", expected " + ssfdtest::show(ssfdExpected)); \
+  } while (0)
+
+#endif // SSFD_TEST_H
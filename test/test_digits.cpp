@@ -0,0 +1,111 @@
+/**
+ * @file test_digits.cpp
+ * @brief Displays with other digit counts (built with SSFD_MAX_DIGITS=8)
+ */
+
+#include "capture_display.h"
+#include <math.h>
+
+typedef SevenSegmentBase::Error Error;
+
+static std::string shown(CaptureDisplay &display)
+{
+    display.scan();
+    return render(display);
+}
+
+static const uint8_t ANIM_2[][2] PROGMEM = {{0x80, 0x00}, {0x00, 0x80}};
+static const uint8_t ANIM_4[][4] PROGMEM = {{0x80, 0x80, 0x80, 0x80}};
+
+TEST(digitCountOutOfRangeFailsBegin)
+{
+    CaptureDisplay none(0);
+    CaptureDisplay tooMany(SevenSegmentBase::MAX_DIGITS + 1);
+    CHECK_EQ(none.getDigitCount(), (uint8_t)0);
+    CHECK(none.begin(ssfdExternalTick) == Error::INVALID_ARGUMENT);
+    CHECK(tooMany.begin(ssfdExternalTick) == Error::INVALID_ARGUMENT);
+    CHECK(!tooMany.isInitialized());
+}
+
+TEST(twoDigitDisplayFormatsIntoTwoCells)
+{
+    CaptureDisplay display(2);
+    display.beginAndSync();
+    display.setNumber(42);
+    CHECK_EQ(shown(display), std::string("42"));
+    display.setNumber(123);
+    CHECK_EQ(shown(display), std::string("99"));
+    display.setFloat(1.25f);
+    CHECK_EQ(shown(display), std::string("1.3"));
+    CHECK(display.setFixed(-3, 0) == Error::OK);
+    CHECK_EQ(shown(display), std::string("-3"));
+    display.setFloat(-12.0f);
+    CHECK_EQ(shown(display), std::string("-9"));
+    CHECK(display.setText("Hi") == Error::OK);
+    CHECK_EQ(shown(display), std::string("Hi"));
+    CHECK(display.setText("Hey") == Error::INVALID_ARGUMENT);
+    display.setFloat(NAN);
+    CHECK_EQ(shown(display), std::string("E "));
+    CHECK_EQ(display.maskErrors, 0u);
+}
+
+TEST(eightDigitDisplayShowsFullRange)
+{
+    CaptureDisplay display(8);
+    display.beginAndSync();
+    display.setLeadingZeros(false);
+    display.setNumber(65535);
+    CHECK_EQ(shown(display), std::string("   65535"));
+    CHECK(display.setFixed(12345678, -4) == Error::OK);
+    CHECK_EQ(shown(display), std::string("1234.5678"));
+    CHECK(display.setFixed(-123456789, 0) == Error::INVALID_ARGUMENT);
+    CHECK_EQ(shown(display), std::string("-9999999"));
+    display.setFloat(2.5f);
+    CHECK_EQ(shown(display), std::string("2.5000000"));
+    CHECK_EQ(display.maskErrors, 0u);
+}
+
+TEST(sixDigitScrollUsesWholeWindow)
+{
+    CaptureDisplay display(6);
+    display.beginAndSync();
+    display.setRefreshRate(100);
+    display.scrollText("ABCDEFG", 10, SevenSegmentBase::ScrollMode::ONCE);
+
+    // One step per frame, taken at the start of each scan
+    display.scan();
+    CHECK_EQ(render(display), std::string("BCDEFG"));
+    display.scan();
+    CHECK_EQ(render(display), std::string("CDEFG "));
+    display.end();
+}
+
+TEST(flatAnimationMatchesDigitCount)
+{
+    CaptureDisplay display(2);
+    display.beginAndSync();
+    CHECK(display.playAnimation(ANIM_4, 1, 10) == Error::INVALID_ARGUMENT);
+    CHECK(display.playAnimationFlat(&ANIM_2[0][0], 2, 125) == Error::OK);
+    display.scan();
+    CHECK_EQ(display.lit[0], (uint8_t)0x00);
+    CHECK_EQ(display.lit[1], (uint8_t)0x80);
+    display.scan();
+    CHECK_EQ(display.lit[0], (uint8_t)0x80);
+    CHECK_EQ(display.lit[1], (uint8_t)0x00);
+    display.end();
+}
+
+TEST(blinkMaskCoversEveryDigit)
+{
+    CaptureDisplay display(6);
+    display.beginAndSync();
+    display.setText("888888");
+    display.startBlink(8); // One frame per phase at 125 Hz
+    display.scan();
+    std::string first = render(display);
+    display.scan();
+    std::string second = render(display);
+    CHECK(first == "      " || second == "      ");
+    CHECK(first == "888888" || second == "888888");
+    display.end();
+}
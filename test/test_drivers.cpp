@@ -0,0 +1,278 @@
+/**
+ * @file test_drivers.cpp
+ * @brief Output drivers: runtime pins, compile-time pins, 74HC595, MAX7219
+ */
+
+#include "SSFD.h"
+#include "SSFD_SPI.h"
+#include "SSFD_Static.h"
+#include "ssfd_test.h"
+
+typedef SevenSegmentBase::Error Error;
+typedef SevenSegmentBase::ScanMode ScanMode;
+
+extern "C" void TIMER1_COMPA_vect(void);
+
+static const uint8_t segmentPins[] PROGMEM = {2, 3, 4, 5, 6, 7, 8, 9};
+static const uint8_t digitPins[] PROGMEM = {10, 11, 12, 13};
+
+// Tick until digit 0 has just been driven
+static void tickToDigit0(SevenSegmentBase &display)
+{
+    for (uint8_t i = 0; i < SevenSegmentBase::NUM_DIGITS; i++)
+    {
+        display.multiplex();
+    }
+}
+
+// ========== SevenSegment ==========
+TEST(runtimePinsWriteSegmentsAndDigitPorts)
+{
+    shim::reset();
+    SevenSegment display(segmentPins, digitPins);
+    CHECK(display.begin(ssfdExternalTick) == Error::OK);
+    display.setNumber(1000);
+    tickToDigit0(display);
+
+    // '1' = b,c -> pins 3,4 (PORTD bits 3,4); digit 0 = pin 10 (PORTB bit 2)
+    CHECK_EQ(PORTD & 0xFC, 0b00011000);
+    CHECK_EQ(PORTB & 0x3C, 0b00000100);
+    display.end();
+}
+
+TEST(runtimePinsRejectInvalidPins)
+{
+    static const uint8_t badPins[] PROGMEM = {2, 3, 4, 5, 6, 7, 8, 99};
+    SevenSegment display(badPins, digitPins);
+    CHECK(display.begin(ssfdExternalTick) == Error::INVALID_PIN);
+    CHECK(!display.isInitialized());
+}
+
+TEST(runtimePinsScanOneSegmentLinePerTick)
+{
+    shim::reset();
+    SevenSegment display(segmentPins, digitPins);
+    CHECK(display.begin(ssfdExternalTick, SevenSegmentBase::ScanOrder::SEGMENTS) == Error::OK);
+    display.setNumber(1000);
+
+    // Segment a (pin 2) on the three '0' digits (pins 11-13)
+    display.multiplex();
+    CHECK_EQ(PORTD & 0xFC, 0b00000100);
+    CHECK_EQ(PORTB & 0x3C, 0b00111000);
+
+    // Segment b (pin 3) on every digit
+    display.multiplex();
+    CHECK_EQ(PORTD & 0xFC, 0b00001000);
+    CHECK_EQ(PORTB & 0x3C, 0b00111100);
+    display.end();
+}
+
+// ========== SevenSegmentT ==========
+TEST(staticPinsMatchRuntimePins)
+{
+    shim::reset();
+    SevenSegmentT<SSFDPins<2, 3, 4, 5, 6, 7, 8, 9>, SSFDPins<10, 11, 12, 13>> display;
+    display.begin(ssfdExternalTick);
+    display.setNumber(1000);
+    tickToDigit0(display);
+    CHECK_EQ(PORTD & 0xFC, 0b00011000);
+    CHECK_EQ(PORTB & 0x3C, 0b00000100);
+    display.end();
+}
+
+TEST(staticDirectMapWritesWholePort)
+{
+    shim::reset();
+    SevenSegmentT<SSFDPins<7, 6, 5, 4, 3, 2, 1, 0>, SSFDPins<8, 9, 10, 11>> display;
+    display.begin(ssfdExternalTick);
+    display.setSegments((const uint8_t[]){0xA5, 0, 0, 0});
+    tickToDigit0(display);
+    CHECK_EQ(PORTD, 0xA5);
+    CHECK_EQ(PORTB & 0x0F, 0b0001);
+    display.end();
+}
+
+TEST(staticCommonAnodeInvertsBothGroups)
+{
+    shim::reset();
+    SevenSegmentT<SSFDPins<2, 3, 4, 5, 6, 7, 8, 9>, SSFDPins<10, 11, 12, 13>, SSFDCommonAnode>
+        display;
+    display.begin(ssfdExternalTick);
+
+    // Every line starts at its off level
+    CHECK_EQ(PORTD & 0xFC, 0xFC);
+    CHECK_EQ(PORTB & 0x3F, 0x3F);
+
+    display.setNumber(1000);
+    tickToDigit0(display);
+    CHECK_EQ(PORTD & 0xFC, 0xFC & ~0b00011000);
+    CHECK_EQ(PORTB & 0x3C, 0x3C & ~0b00000100);
+
+    // Blanking drives the off level, not LOW
+    display.end();
+    CHECK_EQ(PORTD & 0xFC, 0xFC);
+    CHECK_EQ(PORTB & 0x3C, 0x3C);
+}
+
+TEST(staticDirectMapCommonAnodeWritesComplement)
+{
+    shim::reset();
+    SevenSegmentT<SSFDPins<7, 6, 5, 4, 3, 2, 1, 0>, SSFDPins<8, 9, 10, 11>,
+                  SSFDPolarity<true, false>>
+        display;
+    display.begin(ssfdExternalTick);
+    display.setSegments((const uint8_t[]){0xA5, 0, 0, 0});
+    tickToDigit0(display);
+    CHECK_EQ(PORTD, 0x5A);
+    CHECK_EQ(PORTB & 0x0F, 0b0001);
+    display.end();
+}
+
+// ========== SevenSegment595 ==========
+TEST(shiftRegisterSendsDigitThenSegments)
+{
+    shim::reset();
+    SevenSegment595 display(A0);
+    display.begin(ssfdExternalTick);
+    display.setNumber(1000);
+    shim::spiLogLength = 0;
+    tickToDigit0(display);
+
+    // Last tick: digit byte, then segment byte ('1')
+    CHECK(shim::spiLogLength >= 2);
+    CHECK_EQ(shim::spiLog[shim::spiLogLength - 2], 0x01);
+    CHECK_EQ(shim::spiLog[shim::spiLogLength - 1], 0x60);
+    display.end();
+}
+
+/**
+ * @brief 74HC595 that tracks the digit byte on its outputs: drive() latches
+ *        the previous tick's bytes, flushOutput() the queued ones
+ */
+class Latched595 : public SevenSegment595 {
+public:
+  uint8_t shownDigits = 0;
+
+  Latched595() : SevenSegment595(A0) {}
+
+protected:
+  void drive(uint8_t segments, uint8_t digitMask) override {
+    if (_queued) {
+      shownDigits = _queuedDigits;
+    }
+    SevenSegment595::drive(segments, digitMask);
+    _queuedDigits = digitMask;
+    _queued = true;
+  }
+
+  void flushOutput() override {
+    SevenSegment595::flushOutput();
+    if (_queued) {
+      shownDigits = _queuedDigits;
+      _queued = false;
+    }
+  }
+
+private:
+  uint8_t _queuedDigits = 0;
+  bool _queued = false;
+};
+
+TEST(shiftRegisterLatchesDarkBeforeStretchedTick)
+{
+    shim::reset();
+    Latched595 display;
+    display.begin();
+    display.setRefreshRate(250); // 16000 counts per tick: 3 fit in OCR1A
+    display.setText("   5");
+    display.setScanMode(ScanMode::SKIP_FEWER_TICKS);
+    for (int i = 0; i < 8; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+
+    // Digit 3 is latched one tick late, for one base period; the digits
+    // are off before the stretched rest of the frame starts
+    unsigned litPeriods = 0;
+    unsigned stretched = 0;
+    for (int i = 0; i < 6; i++)
+    {
+        TIMER1_COMPA_vect();
+        if (OCR1A != 15999)
+        {
+            stretched++;
+            CHECK_EQ(OCR1A, (uint16_t)31999);
+            CHECK_EQ(display.shownDigits, (uint8_t)0);
+        }
+        else if (display.shownDigits == 0x08)
+        {
+            litPeriods++;
+        }
+    }
+    CHECK_EQ(stretched, 2u);
+    CHECK_EQ(litPeriods, 2u);
+    display.end();
+}
+
+TEST(shiftRegisterBlankKeepsNextDigitQueued)
+{
+    shim::reset();
+    SevenSegment595 display(A0);
+    display.begin(ssfdExternalTick);
+    display.setNumber(1000);
+    tickToDigit0(display);
+    shim::spiLogLength = 0;
+    ssfdExternalTick.blank();
+
+    // Dark pair latched, then the queued digit 0 pair sent again
+    CHECK_EQ(shim::spiLogLength, (size_t)4);
+    CHECK_EQ(shim::spiLog[0], 0x00);
+    CHECK_EQ(shim::spiLog[1], 0x00);
+    CHECK_EQ(shim::spiLog[2], 0x01);
+    CHECK_EQ(shim::spiLog[3], 0x60);
+    display.end();
+}
+
+// ========== SevenSegmentMax7219 ==========
+TEST(max7219PushesOnlyChangedDigits)
+{
+    shim::reset();
+    SevenSegmentMax7219 display(A0);
+    CHECK(display.begin() == Error::OK);
+    display.setNumber(1234);
+    shim::spiLogLength = 0;
+    display.setNumber(1235);
+
+    // One register write (address, data) for the last digit only
+    CHECK_EQ(shim::spiLogLength, (size_t)2);
+    CHECK_EQ(shim::spiLog[0], 4);
+    CHECK(display.scrollText("HELLO") == Error::NOT_SUPPORTED);
+    display.end();
+}
+
+TEST(max7219BrightnessSetsIntensityRegister)
+{
+    shim::reset();
+    SevenSegmentMax7219 display(A0);
+    display.begin();
+    shim::spiLogLength = 0;
+    CHECK(display.setBrightness(0x90) == Error::OK);
+    CHECK_EQ(shim::spiLogLength, (size_t)2);
+    CHECK_EQ(shim::spiLog[0], 0x0A);
+    CHECK_EQ(shim::spiLog[1], 9);
+    CHECK(display.fadeTo(0, 500) == Error::NOT_SUPPORTED);
+    display.end();
+}
+
+TEST(max7219KeepsItsOwnScanOrder)
+{
+    shim::reset();
+    SevenSegmentMax7219 display(A0);
+    SevenSegmentBase &base = display;
+    CHECK(base.begin(ssfdExternalTick, SevenSegmentBase::ScanOrder::SEGMENTS) ==
+          Error::NOT_SUPPORTED);
+    CHECK(!display.isInitialized());
+    CHECK(display.begin() == Error::OK);
+    CHECK(display.getScanOrder() == SevenSegmentBase::ScanOrder::DIGITS);
+    display.end();
+}
@@ -0,0 +1,78 @@
+/**
+ * @file test_font.cpp
+ * @brief Font table and setText()
+ */
+
+#include "capture_display.h"
+
+typedef SevenSegmentBase::Error Error;
+
+static uint8_t glyph(char c)
+{
+    return pgm_read_byte(&ssfdFont[(uint8_t)c]);
+}
+
+TEST(fontMatchesDigitPatterns)
+{
+    static const uint8_t digits[] = {0xFC, 0x60, 0xDA, 0xF2, 0x66, 0xB6, 0xBE, 0xE0, 0xFE, 0xF6};
+    for (uint8_t d = 0; d < 10; d++)
+    {
+        CHECK_EQ(glyph('0' + d), digits[d]);
+    }
+}
+
+TEST(fontHasDistinctLowercase)
+{
+    CHECK(glyph('a') != glyph('A'));
+    CHECK(glyph('c') != glyph('C'));
+    CHECK(glyph('o') != glyph('O'));
+    CHECK(glyph('u') != glyph('U'));
+    CHECK(glyph('h') != glyph('H'));
+}
+
+TEST(fontHasPunctuation)
+{
+    CHECK_EQ(glyph('_'), (uint8_t)0b00010000);
+    CHECK_EQ(glyph('-'), (uint8_t)0b00000010);
+    CHECK_EQ(glyph('='), (uint8_t)0b00010010);
+    CHECK_EQ(glyph(SSFD_CHAR_DEGREE), (uint8_t)0b11000110);
+    CHECK(glyph('?') != 0);
+    CHECK(glyph('\'') != 0);
+    CHECK(glyph('"') != 0);
+}
+
+TEST(setTextPadsShortStrings)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    CHECK(display.setText("HE") == Error::OK);
+    display.scan();
+    CHECK_EQ(render(display), std::string("HE  "));
+}
+
+TEST(setTextMapsEveryCharacterThroughFont)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setText("21" SSFD_STR_DEGREE "c");
+    display.scan();
+    CHECK_EQ(display.lit[2], glyph(SSFD_CHAR_DEGREE));
+    CHECK_EQ(display.lit[3], glyph('c'));
+}
+
+TEST(setTextShowsUnknownAsBlank)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setText("\x01#\x80");
+    display.scan();
+    CHECK_EQ(render(display), std::string("    "));
+}
+
+TEST(setTextRejectsInvalidInput)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    CHECK(display.setText(nullptr) == Error::NULL_POINTER);
+    CHECK(display.setText("TOO LONG") == Error::INVALID_ARGUMENT);
+}
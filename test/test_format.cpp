@@ -0,0 +1,295 @@
+/**
+ * @file test_format.cpp
+ * @brief Number formatting: setNumber, setHundredths, setFloat, setFixed,
+ *        setInt, setHex, print()
+ */
+
+#include "capture_display.h"
+#include <math.h>
+
+typedef SevenSegmentBase::Error Error;
+
+static std::string shown(CaptureDisplay &display)
+{
+    display.scan();
+    return render(display);
+}
+
+// ========== setNumber() ==========
+TEST(setNumberShowsLeadingZerosByDefault)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setNumber(42);
+    CHECK_EQ(shown(display), std::string("0042"));
+}
+
+TEST(setNumberSuppressesLeadingZeros)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setLeadingZeros(false);
+    display.setNumber(42);
+    CHECK_EQ(shown(display), std::string("  42"));
+    display.setNumber(0);
+    CHECK_EQ(shown(display), std::string("   0"));
+}
+
+TEST(setNumberKeepsUnitsDigitBeforeDecimalPoint)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setLeadingZeros(false);
+    display.setNumber(5, 2);
+    CHECK_EQ(shown(display), std::string("  0.5"));
+    display.setNumber(1234, 1);
+    CHECK_EQ(shown(display), std::string("12.34"));
+}
+
+TEST(setNumberClampsToMaxValue)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setNumber(12345);
+    CHECK_EQ(shown(display), std::string("9999"));
+}
+
+TEST(setNumberMatchesDivisionForAllValues)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    for (uint16_t value = 0; value <= 9999; value++)
+    {
+        display.setNumber(value);
+        char expected[5];
+        snprintf(expected, sizeof(expected), "%04u", value);
+        std::string actual = shown(display);
+        if (actual != expected)
+        {
+            CHECK_EQ(actual, std::string(expected));
+            return;
+        }
+    }
+}
+
+// ========== setHundredths() ==========
+TEST(setHundredthsTakesDecimalPointPosition)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setHundredths(1234, 1);
+    CHECK_EQ(shown(display), std::string("12.34"));
+    display.setHundredths(560, 1);
+    CHECK_EQ(shown(display), std::string("05.60"));
+    display.setHundredths(1234);
+    CHECK_EQ(shown(display), std::string("123.4"));
+    display.setHundredths(1234, 3);
+    CHECK_EQ(shown(display), std::string("1234."));
+}
+
+// ========== setFloat() ==========
+TEST(setFloatPicksDecimalsByMagnitude)
+{
+    struct
+    {
+        float value;
+        const char *text;
+    } cases[] = {
+        {1.234f, "1.234"},  {12.34f, "12.34"},   {123.45f, "123.5"},
+        {1234.5f, "1235"},  {9.9996f, "10.00"},  {99.996f, "100.0"},
+        {-1.23f, "-1.23"},  {-12.34f, "-12.3"},  {-9.996f, "-10.0"},
+        {-99.96f, "-100"},  {-150.0f, "-999"},
+    };
+
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setLeadingZeros(false);
+    for (auto &c : cases)
+    {
+        CHECK(display.setFloat(c.value) == Error::OK);
+        CHECK_EQ(shown(display), std::string(c.text));
+    }
+}
+
+TEST(setFloatRejectsNanAndInfinity)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    CHECK(display.setFloat(NAN) == Error::INVALID_ARGUMENT);
+    CHECK_EQ(shown(display), std::string("ERR ")); // r and R share a glyph
+    CHECK(display.setFloat(INFINITY) == Error::INVALID_ARGUMENT);
+}
+
+// ========== setFixed() ==========
+TEST(setFixedScalesMantissa)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setLeadingZeros(false);
+    display.setFixed(1234, -2);
+    CHECK_EQ(shown(display), std::string("12.34"));
+    display.setFixed(123456, -3);
+    CHECK_EQ(shown(display), std::string("123.5"));
+    display.setFixed(12, 2);
+    CHECK_EQ(shown(display), std::string("1200"));
+    display.setFixed(-12345, -3);
+    CHECK_EQ(shown(display), std::string("-12.3"));
+}
+
+TEST(setFixedSaturatesOnOverflow)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    CHECK(display.setFixed(10000, 0) == Error::INVALID_ARGUMENT);
+    CHECK_EQ(shown(display), std::string("9999"));
+    CHECK(display.setFixed(-1000, 0) == Error::INVALID_ARGUMENT);
+    CHECK_EQ(shown(display), std::string("-999"));
+}
+
+// ========== setInt() ==========
+TEST(setIntShowsSignedRange)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    CHECK(display.setInt(-999) == Error::OK);
+    CHECK_EQ(shown(display), std::string("-999"));
+    CHECK(display.setInt(9999) == Error::OK);
+    CHECK_EQ(shown(display), std::string("9999"));
+
+    display.setLeadingZeros(false);
+    display.setInt(-42);
+    CHECK_EQ(shown(display), std::string("- 42"));
+}
+
+TEST(setIntSaturatesOutOfRange)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    CHECK(display.setInt(-1000) == Error::INVALID_ARGUMENT);
+    CHECK_EQ(shown(display), std::string("-999"));
+    CHECK(display.setInt(10000) == Error::INVALID_ARGUMENT);
+    CHECK_EQ(shown(display), std::string("9999"));
+    CHECK(display.getLastError() == Error::INVALID_ARGUMENT);
+}
+
+// ========== setHex() ==========
+TEST(setHexShowsFourZeroPaddedNibbles)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setLeadingZeros(false); // Hex is always zero padded
+    CHECK(display.setHex(0x00A5) == Error::OK);
+    CHECK_EQ(shown(display), std::string("00A5"));
+    display.setHex(0xC0DE);
+    CHECK_EQ(shown(display), std::string("C0DE")); // d and D share a glyph
+
+    // Repeats are change-detected like setNumber()
+    CHECK(display.setHex(0xC0DE) == Error::OK);
+    CHECK_EQ(shown(display), std::string("C0DE"));
+}
+
+TEST(setHexFitsDisplayWidth)
+{
+    CaptureDisplay narrow(2);
+    narrow.beginAndSync();
+    CHECK(narrow.setHex(0x3F) == Error::OK);
+    CHECK_EQ(shown(narrow), std::string("3F"));
+    CHECK(narrow.setHex(0x100) == Error::INVALID_ARGUMENT);
+    CHECK_EQ(shown(narrow), std::string("FF"));
+}
+
+// ========== print() ==========
+TEST(printRendersHexWithoutBuffer)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    CHECK_EQ(display.print(0xBEEFu, HEX), (size_t)4);
+    CHECK_EQ(shown(display), std::string("BEEF")); // b and B share a glyph
+}
+
+TEST(printMergesDotIntoPreviousDigit)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.print("1.25");
+    CHECK_EQ(shown(display), std::string("1.25 "));
+
+    // A leading dot or a second dot takes its own cell
+    display.println();
+    display.print(".5..");
+    CHECK_EQ(shown(display), std::string(" .5. . "));
+}
+
+TEST(printContinuesAtCursorUntilNewline)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.print(-12);
+    display.print('C');
+    CHECK_EQ(shown(display), std::string("-12C"));
+    CHECK_EQ(display.print('X'), (size_t)0); // Past the last digit
+
+    display.println(7);
+    display.println(42);
+    CHECK_EQ(shown(display), std::string("42  "));
+}
+
+TEST(printCursorAndClearRewind)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.print("0000");
+    CHECK(display.setCursor(2) == Error::OK);
+    display.print("AB");
+    CHECK_EQ(shown(display), std::string("00AB"));
+    CHECK(display.setCursor(4) == Error::INVALID_ARGUMENT);
+
+    display.clear();
+    display.print(5);
+    CHECK_EQ(shown(display), std::string("5   "));
+}
+
+TEST(printInsideFrameIsOnePublish)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.beginFrame();
+    display.print(3);
+    display.print('.');
+    display.print(14);
+    display.scan();
+    CHECK_EQ(render(display), std::string("    "));
+    display.commit();
+    CHECK_EQ(shown(display), std::string("3.14 "));
+}
+
+// ========== CHANGE DETECTION ==========
+TEST(repeatedCallReturnsCachedResult)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    CHECK(display.setFixed(10000, 0) == Error::INVALID_ARGUMENT);
+    CHECK(display.setFixed(10000, 0) == Error::INVALID_ARGUMENT);
+    CHECK(display.setFloat(NAN) == Error::INVALID_ARGUMENT);
+    CHECK(display.setFloat(NAN) == Error::INVALID_ARGUMENT);
+    CHECK_EQ(shown(display), std::string("ERR "));
+}
+
+TEST(repeatAfterOtherChangesRecomposes)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setNumber(5);
+    display.setText("HI");
+    display.setNumber(5);
+    CHECK_EQ(shown(display), std::string("0005"));
+
+    display.setLeadingZeros(false);
+    display.setNumber(5);
+    CHECK_EQ(shown(display), std::string("   5"));
+
+    display.setFloat(1.5f);
+    display.clear();
+    display.setFloat(1.5f);
+    CHECK_EQ(shown(display), std::string("1.500"));
+}
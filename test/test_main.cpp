@@ -0,0 +1,61 @@
+/**
+ * @file test_main.cpp
+ * @brief Runner for the ssfd_test.h harness
+ */
+
+#include "ssfd_test.h"
+
+namespace ssfdtest {
+
+static TestCase *head = nullptr;
+static TestCase *tail = nullptr;
+static int currentFailures = 0;
+
+// ========== Registrar ==========
+Registrar::Registrar(TestCase *test)
+{
+    // Keep declaration order so output follows the source file
+    if (tail == nullptr)
+    {
+        head = test;
+    }
+    else
+    {
+        tail->next = test;
+    }
+    tail = test;
+}
+
+// ========== fail() ==========
+void fail(const char *file, int line, const std::string &message)
+{
+    currentFailures++;
+    printf("  %s:%d: %s\n", file, line, message.c_str());
+}
+
+// ========== runAll() ==========
+int runAll()
+{
+    int failed = 0;
+    int total = 0;
+    for (TestCase *test = head; test != nullptr; test = test->next)
+    {
+        currentFailures = 0;
+        test->fn();
+        total++;
+        if (currentFailures != 0)
+        {
+            failed++;
+        }
+        printf("%s %s\n", currentFailures == 0 ? "[ OK ]" : "[FAIL]", test->name);
+    }
+    printf("%d/%d tests passed\n", total - failed, total);
+    return failed;
+}
+
+} // namespace ssfdtest
+
+int main()
+{
+    return ssfdtest::runAll() == 0 ? 0 : 1;
+}
@@ -0,0 +1,621 @@
+/**
+ * @file test_multiplex.cpp
+ * @brief Scan order, frame publishing, blinking and the ISR display modes
+ *        (marquee, wiring test, animation, counter)
+ */
+
+#include "capture_display.h"
+
+typedef SevenSegmentBase::Error Error;
+typedef SevenSegmentBase::ScrollMode ScrollMode;
+typedef SevenSegmentBase::ScanMode ScanMode;
+typedef SevenSegmentBase::ScanOrder ScanOrder;
+typedef SevenSegmentBase::CounterFormat CounterFormat;
+
+extern "C" void TIMER1_COMPA_vect(void);
+
+// ========== SCAN ==========
+TEST(multiplexIsIdleBeforeBegin)
+{
+    CaptureDisplay display;
+    display.multiplex();
+    CHECK_EQ(display.drives, 0u);
+}
+
+TEST(multiplexLightsOneDigitPerTick)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setText("ABCD");
+    display.scan(2);
+    CHECK_EQ(display.maskErrors, 0u);
+    CHECK_EQ(render(display), std::string("ABCD")); // d and D share a glyph
+}
+
+TEST(publishedFrameSwapsOnlyAtDigitZero)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setNumber(1111);
+    display.scan();
+
+    // Publish mid-frame: the rest of this frame keeps the old patterns
+    display.multiplex();
+    display.setNumber(2222);
+    display.multiplex();
+    display.multiplex();
+    display.multiplex();
+    CHECK_EQ(render(display).substr(1), std::string("111"));
+
+    display.scan();
+    CHECK_EQ(render(display), std::string("2222"));
+}
+
+TEST(clearBlanksAllDigits)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setNumber(8888, 0);
+    display.clear();
+    display.scan();
+    CHECK_EQ(render(display), std::string("    "));
+}
+
+// ========== SCAN MODES ==========
+// ========== FRAME BUILDER ==========
+TEST(frameBuilderShowsNothingUntilCommit)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setNumber(1111);
+    display.scan();
+
+    display.beginFrame();
+    CHECK(display.putDigit(0, 4) == Error::OK);
+    CHECK(display.putDigit(1, 2) == Error::OK);
+    CHECK(display.putChar(3, 'C') == Error::OK);
+    display.scan();
+    CHECK_EQ(render(display), std::string("1111"));
+
+    display.commit();
+    CHECK(!display.isFrameOpen());
+    display.scan();
+    CHECK_EQ(render(display), std::string("42 C"));
+}
+
+TEST(settersComposeIntoOpenFrame)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.beginFrame();
+    display.setNumber(25);
+    display.putChar(0, 'P');
+    display.putDP(2);
+    display.scan();
+    CHECK_EQ(render(display), std::string("    "));
+
+    display.commit();
+    display.scan();
+    CHECK_EQ(render(display), std::string("P02.5"));
+
+    // The patched frame is not the one setNumber(25) made on its own
+    display.setNumber(25);
+    display.scan();
+    CHECK_EQ(render(display), std::string("0025"));
+}
+
+TEST(lonePutPatchesOneDigit)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setNumber(1234);
+
+    // Builds on the pending frame even before the ISR picked it up
+    CHECK(display.putDP(1) == Error::OK);
+    display.scan();
+    CHECK_EQ(render(display), std::string("12.34"));
+
+    display.putDP(1, false);
+    display.putDigit(3, 0xF);
+    display.scan();
+    CHECK_EQ(render(display), std::string("123F"));
+}
+
+TEST(frameBuilderKeepsLatestFrameWhenAsked)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setText("ABCD");
+    display.beginFrame(false);
+    display.putRaw(0, 0);
+    display.commit();
+    display.scan();
+    CHECK_EQ(render(display), std::string(" BCD"));
+}
+
+TEST(frameBuilderRejectsBadArguments)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    CHECK(display.putRaw(4, 0xFF) == Error::INVALID_ARGUMENT);
+    CHECK(display.putChar(255, 'A') == Error::INVALID_ARGUMENT);
+    CHECK(display.putDigit(0, 16) == Error::INVALID_ARGUMENT);
+    CHECK(!display.isFrameOpen());
+}
+
+TEST(skipBrighterScansOnlyLitDigits)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setText("1  5");
+    display.setScanMode(ScanMode::SKIP_BRIGHTER);
+    CHECK(display.getScanMode() == ScanMode::SKIP_BRIGHTER);
+    display.scan();
+
+    display.resetCounts();
+    for (int i = 0; i < 8; i++)
+    {
+        display.multiplex();
+    }
+    CHECK_EQ(display.litTicks[0], 4u);
+    CHECK_EQ(display.litTicks[3], 4u);
+    CHECK_EQ(display.drives, 8u);
+
+    // Back to a full frame: every digit again
+    display.setText("1234");
+    display.scan(2);
+    display.resetCounts();
+    display.scan();
+    for (uint8_t d = 0; d < 4; d++)
+    {
+        CHECK_EQ(display.litTicks[d], 1u);
+    }
+}
+
+TEST(skipBrighterKeepsFrameTiming)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setRefreshRate(100);
+    display.setText("   5");
+    display.setScanMode(ScanMode::SKIP_BRIGHTER);
+    display.startBlink(50); // 5 frames = 20 ticks per phase
+
+    unsigned hiddenTicks = 0;
+    for (int i = 0; i < 40; i++)
+    {
+        display.multiplex();
+        if (display.lastMask() == 0)
+        {
+            hiddenTicks++;
+        }
+    }
+    CHECK_EQ(hiddenTicks, 20u);
+}
+
+TEST(skipFewerTicksStretchesOneDarkTick)
+{
+    shim::reset();
+    CaptureDisplay display;
+    display.begin();
+    display.setRefreshRate(250); // 16000 counts per tick: 3 fit in OCR1A
+    display.setText("   5");
+    display.setScanMode(ScanMode::SKIP_FEWER_TICKS);
+    for (int i = 0; i < 8; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+
+    // Two interrupts per frame: digit 3 for one period, dark for three
+    display.resetCounts();
+    uint16_t periods[4];
+    for (int i = 0; i < 4; i++)
+    {
+        TIMER1_COMPA_vect();
+        periods[i] = OCR1A;
+    }
+    CHECK_EQ(display.litTicks[3], 2u);
+    CHECK_EQ(display.drives, 4u);
+    CHECK((periods[0] == 15999 && periods[1] == 47999) ||
+          (periods[0] == 47999 && periods[1] == 15999));
+    CHECK_EQ(periods[2], periods[0]);
+
+    // A full frame restores the programmed period
+    display.setText("1234");
+    for (int i = 0; i < 8; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK_EQ(OCR1A, (uint16_t)15999);
+    display.end();
+}
+
+// ========== SEGMENT ORDER ==========
+// One segment-order scan, the digits of each tick's segment line merged back
+// into a frame; fails if a tick drives more than one line
+static std::string scanSegments(CaptureDisplay &display)
+{
+    uint8_t frame[SevenSegmentBase::MAX_DIGITS] = {};
+    for (uint8_t s = 0; s < SevenSegmentBase::NUM_SEGMENTS; s++)
+    {
+        display.multiplex();
+        uint8_t segments = display.lastSegments();
+        CHECK((segments & (segments - 1)) == 0);
+        for (uint8_t d = 0; d < display.getDigitCount(); d++)
+        {
+            if (display.lastMask() & (1 << d))
+            {
+                frame[d] |= segments;
+            }
+        }
+    }
+    return render(frame, display.getDigitCount());
+}
+
+TEST(segmentOrderLightsEachLineOnItsDigits)
+{
+    CaptureDisplay display;
+    CHECK(display.begin(ssfdExternalTick, ScanOrder::SEGMENTS) == Error::OK);
+    CHECK(display.getScanOrder() == ScanOrder::SEGMENTS);
+    display.setText("12 7");
+    CHECK_EQ(scanSegments(display), std::string("12 7"));
+
+    // Segment a first: digits 1 and 3 ('2', '7'), then b on all three
+    display.multiplex();
+    CHECK_EQ(display.lastSegments(), (uint8_t)0x80);
+    CHECK_EQ(display.lastMask(), (uint8_t)0b1010);
+    display.multiplex();
+    CHECK_EQ(display.lastMask(), (uint8_t)0b1011);
+    for (int i = 2; i < 8; i++)
+    {
+        display.multiplex();
+    }
+
+    // A new frame is transposed again at the scan boundary, DP line included
+    display.setNumber(8888, 1);
+    CHECK_EQ(scanSegments(display), std::string("88.88"));
+}
+
+TEST(segmentOrderTicksOncePerSegmentLine)
+{
+    shim::reset();
+    CaptureDisplay display;
+    CHECK(display.begin(ScanOrder::SEGMENTS) == Error::OK);
+
+    // 125 Hz x 8 segment lines = 1000 ticks/s -> 16000 counts at 16 MHz
+    CHECK_EQ(OCR1A, (uint16_t)15999);
+    CHECK_EQ(display.getTickRate(), 1000ul);
+
+    // Back to the default order: one tick per digit again
+    CHECK(display.begin() == Error::OK);
+    CHECK(display.getScanOrder() == ScanOrder::DIGITS);
+    CHECK_EQ(OCR1A, (uint16_t)31999);
+    display.end();
+}
+
+TEST(segmentOrderSkipsUnusedLines)
+{
+    CaptureDisplay display;
+    display.begin(ssfdExternalTick, ScanOrder::SEGMENTS);
+    display.setText("  11");
+    display.setScanMode(ScanMode::SKIP_BRIGHTER);
+    display.multiplex();
+
+    // '1' is b and c: two lines share every tick, twice as bright
+    display.resetCounts();
+    unsigned lineTicks[2] = {};
+    for (int i = 0; i < 8; i++)
+    {
+        display.multiplex();
+        CHECK_EQ(display.lastMask(), (uint8_t)0b1100);
+        lineTicks[display.lastSegments() == 0x40 ? 0 : 1]++;
+    }
+    CHECK_EQ(lineTicks[0], 4u);
+    CHECK_EQ(lineTicks[1], 4u);
+}
+
+TEST(segmentOrderBlinkMasksHiddenDigits)
+{
+    CaptureDisplay display;
+    display.begin(ssfdExternalTick, ScanOrder::SEGMENTS);
+    display.setRefreshRate(100);
+    display.setNumber(8888);
+    display.startBlink(50, 0b0011); // 5 frames per phase
+    scanSegments(display);
+
+    // Visible phase first, then the masked digits drop out of every line
+    std::string phases;
+    for (int frame = 0; frame < 10; frame++)
+    {
+        std::string shown = scanSegments(display);
+        if (phases.empty() || phases.substr(phases.size() - 4) != shown)
+        {
+            phases += shown;
+        }
+    }
+    CHECK_EQ(phases.substr(0, 8), std::string("8888  88"));
+}
+
+// ========== BLINK ==========
+TEST(blinkHidesMaskedDigitsEachPhase)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setRefreshRate(100); // 10 ms frames
+    display.setNumber(1234);
+    display.startBlink(50, 0b0011);
+    CHECK(display.isBlinking());
+
+    display.scan(5);
+    CHECK_EQ(render(display), std::string("  34"));
+    display.scan(5);
+    CHECK_EQ(render(display), std::string("1234"));
+
+    display.stopBlink();
+    display.scan();
+    CHECK_EQ(render(display), std::string("1234"));
+}
+
+// ========== MARQUEE ==========
+TEST(scrollWrapsAfterBlankWindow)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setRefreshRate(100);
+    CHECK(display.scrollText("HELP ME", 10) == Error::OK);
+
+    std::string frames;
+    for (int i = 0; i < 12; i++)
+    {
+        display.scan();
+        frames += render(display) + "|";
+    }
+    CHECK_EQ(frames, std::string("ELP |LP M|P ME| ME |ME  |E   |    |   H|  HE| HEL|HELP|ELP |"));
+}
+
+TEST(scrollBouncesBetweenEnds)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setRefreshRate(100);
+    display.scrollText("123456", 10, ScrollMode::BOUNCE);
+
+    std::string frames;
+    for (int i = 0; i < 5; i++)
+    {
+        display.scan();
+        frames += render(display) + "|";
+    }
+    CHECK_EQ(frames, std::string("2345|3456|2345|1234|2345|"));
+}
+
+static unsigned scrollDoneCalls;
+static void onScrollDone()
+{
+    scrollDoneCalls++;
+}
+
+TEST(scrollOnceCallsBackAndRestoresStaticFrame)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setRefreshRate(100);
+    display.setNumber(42);
+    scrollDoneCalls = 0;
+    display.scrollText(F("HI"), 10, ScrollMode::ONCE, onScrollDone);
+
+    display.scan(3);
+    CHECK(!display.isScrolling());
+    CHECK_EQ(scrollDoneCalls, 1u);
+    display.scan();
+    CHECK_EQ(render(display), std::string("0042"));
+}
+
+TEST(scrollRejectsNull)
+{
+    CaptureDisplay display;
+    CHECK(display.scrollText((const char *)nullptr) == Error::NULL_POINTER);
+}
+
+// ========== WIRING TEST ==========
+static unsigned wiringDoneCalls;
+static void onWiringDone()
+{
+    wiringDoneCalls++;
+}
+
+TEST(wiringTestWalksSegmentsThenDigits)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setRefreshRate(100);
+    display.setNumber(42);
+    display.startBlink(20, 0x01); // Must not hide test steps
+    wiringDoneCalls = 0;
+    CHECK(display.startWiringTest(10, onWiringDone) == Error::OK);
+    CHECK(display.isTestingWiring());
+
+    // Step 0 (segment a) is rendered on start; each frame advances one step
+    std::string steps;
+    for (int i = 0; i < 11; i++)
+    {
+        display.scan();
+        steps += std::to_string(display.lit[0]) + "/" + std::to_string(display.lit[3]) + ",";
+    }
+    CHECK_EQ(steps, std::string("64/64,32/32,16/16,8/8,4/4,2/2,1/1,255/0,0/0,0/0,0/255,"));
+    CHECK_EQ(wiringDoneCalls, 0u);
+
+    // Setters stage the frame shown afterwards
+    display.stopBlink();
+    display.setNumber(7);
+    display.scan();
+    CHECK(!display.isTestingWiring());
+    CHECK_EQ(wiringDoneCalls, 1u);
+    CHECK_EQ(render(display), std::string("0007"));
+}
+
+TEST(wiringTestResumesMarquee)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setRefreshRate(100);
+    display.scrollText("HELP ME", 10);
+    display.scan(2);
+    CHECK_EQ(render(display), std::string("LP M"));
+
+    display.startWiringTest(10);
+    CHECK(!display.isScrolling());
+    display.scan(3);
+    display.stopWiringTest();
+    CHECK(display.isScrolling());
+    display.scan();
+    CHECK_EQ(render(display), std::string("P ME"));
+
+    // A marquee stopped during the test stays stopped
+    display.startWiringTest(10);
+    display.stopScroll();
+    display.scan(12);
+    CHECK(!display.isTestingWiring());
+    CHECK(!display.isScrolling());
+}
+
+// ========== ANIMATION ==========
+static const uint8_t ANIM_A[][4] PROGMEM = {{1, 1, 1, 1}, {2, 2, 2, 2}};
+static const uint8_t ANIM_B[][4] PROGMEM = {{9, 9, 9, 9}};
+
+TEST(animationPlaysLoopsThenQueue)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setRefreshRate(100);
+    display.setSegments((const uint8_t[]){0x80, 0x80, 0x80, 0x80});
+    CHECK(display.playAnimation(ANIM_A, 2, 100, 2) == Error::OK);
+    CHECK(display.queueAnimation(ANIM_B, 1, 100, 1) == Error::OK);
+
+    std::string seq;
+    for (int i = 0; i < 7; i++)
+    {
+        display.scan();
+        seq += std::to_string(display.lit[0]) + ",";
+    }
+    CHECK_EQ(seq, std::string("2,1,2,9,128,128,128,"));
+    CHECK(!display.isAnimating());
+}
+
+TEST(animationRejectsBadArguments)
+{
+    CaptureDisplay display;
+    CHECK(display.playAnimation(nullptr, 1, 10) == Error::NULL_POINTER);
+    CHECK(display.playAnimation(ANIM_A, 0, 10) == Error::INVALID_ARGUMENT);
+    CHECK(display.playAnimation(ANIM_A, 2, 0) == Error::INVALID_ARGUMENT);
+}
+
+// ========== COUNTER ==========
+// 8 ms is exactly one frame at the default 125 Hz
+TEST(counterCarriesDecimalDigits)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    CHECK(display.startCounter(98, 8) == Error::OK);
+    CHECK(display.isCounting());
+    display.scan();
+    CHECK_EQ(render(display), std::string("0099"));
+    display.scan();
+    CHECK_EQ(render(display), std::string("0100"));
+    CHECK_EQ(display.getCounter(), 100u);
+
+    // Odometer wrap, and a multi-digit step
+    display.startCounter(9990, 8, CounterFormat::DECIMAL, 25);
+    display.scan();
+    CHECK_EQ(render(display), std::string("0015"));
+}
+
+TEST(counterCarriesMinutesAndSeconds)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.startCounter(59, 8, CounterFormat::MM_SS);
+    display.scan();
+    CHECK_EQ(render(display), std::string("01.00"));
+    CHECK_EQ(display.getCounter(), 60u);
+
+    display.startCounter(5999, 8, CounterFormat::MM_SS);
+    display.scan();
+    CHECK_EQ(render(display), std::string("00.00"));
+
+    // Counting down borrows across the colon
+    display.startCounter(60, 8, CounterFormat::MM_SS, -1);
+    display.scan();
+    CHECK_EQ(render(display), std::string("00.59"));
+    display.setLeadingZeros(false);
+    display.scan();
+    CHECK_EQ(render(display), std::string(" 0.58"));
+}
+
+TEST(counterPeriodDoesNotDrift)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+
+    // 20 ms = 2.5 frames: steps after frames 3 and 5, never rounded
+    display.startCounter(0, 20);
+    display.scan(4);
+    CHECK_EQ(display.getCounter(), 1u);
+    display.scan();
+    CHECK_EQ(display.getCounter(), 2u);
+    display.scan(495);
+    CHECK_EQ(display.getCounter(), 200u);
+
+    // A rate change keeps the time already counted into the period
+    display.startCounter(0, 1000);
+    display.scan(62); // 496 ms
+    CHECK(display.setRefreshRate(250) == Error::OK);
+    display.scan(125); // 996 ms
+    CHECK_EQ(display.getCounter(), 0u);
+    display.scan();
+    CHECK_EQ(display.getCounter(), 1u);
+}
+
+TEST(counterPausesAndRestoresStaticFrame)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.startCounter(5, 8);
+    display.setNumber(7); // Staged behind the counter
+    display.pauseCounter();
+    display.scan(3);
+    CHECK_EQ(render(display), std::string("0005"));
+    display.pauseCounter(false);
+    display.scan();
+    CHECK_EQ(render(display), std::string("0006"));
+
+    display.stopCounter();
+    display.scan();
+    CHECK(!display.isCounting());
+    CHECK_EQ(render(display), std::string("0007"));
+    CHECK_EQ(display.getCounter(), 6u);
+}
+
+TEST(counterResumesAfterWiringTest)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.startCounter(42, 8);
+    display.startWiringTest(10);
+    display.scan(2);
+    display.stopWiringTest();
+    CHECK(display.isCounting());
+    display.scan();
+    CHECK_EQ(render(display), std::string("0043")); // Held during the test
+}
+
+TEST(counterRejectsBadArguments)
+{
+    CaptureDisplay display;
+    CHECK(display.startCounter(0, 0) == Error::INVALID_ARGUMENT);
+    CHECK(display.startCounter(0, 8, CounterFormat::DECIMAL, 0) == Error::INVALID_ARGUMENT);
+    CHECK(display.startCounter(10000, 8) == Error::INVALID_ARGUMENT);
+    CHECK(display.startCounter(6000, 8, CounterFormat::MM_SS) == Error::INVALID_ARGUMENT);
+    CHECK(display.startCounter(0, 8, CounterFormat::MM_SS, 6000) == Error::INVALID_ARGUMENT);
+    CHECK(!display.isCounting());
+}
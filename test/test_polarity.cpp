@@ -0,0 +1,85 @@
+/**
+ * @file test_polarity.cpp
+ * @brief Active-low segment and digit lines on the runtime drivers
+ *        (built with SSFD_SEGMENTS_ACTIVE_LOW=1 SSFD_DIGITS_ACTIVE_LOW=1)
+ */
+
+#include "SSFD.h"
+#include "SSFD_SPI.h"
+#include "ssfd_test.h"
+
+typedef SevenSegmentBase::Error Error;
+
+static const uint8_t segmentPins[] PROGMEM = {2, 3, 4, 5, 6, 7, 8, 9};
+static const uint8_t digitPins[] PROGMEM = {10, 11, 12, 13};
+
+// Tick until digit 0 has just been driven
+static void tickToDigit0(SevenSegmentBase &display)
+{
+    for (uint8_t i = 0; i < SevenSegmentBase::NUM_DIGITS; i++)
+    {
+        display.multiplex();
+    }
+}
+
+// ========== SevenSegment ==========
+TEST(runtimePinsStartAtOffLevel)
+{
+    shim::reset();
+    SevenSegment display(segmentPins, digitPins);
+    CHECK(display.begin(ssfdExternalTick) == Error::OK);
+    CHECK_EQ(PORTD & 0xFC, 0xFC);
+    CHECK_EQ(PORTB & 0x3F, 0x3F);
+    CHECK_EQ(shim::pinDirection[2], OUTPUT);
+    display.end();
+}
+
+TEST(runtimePinsDriveActiveLow)
+{
+    shim::reset();
+    SevenSegment display(segmentPins, digitPins);
+    display.begin(ssfdExternalTick);
+    display.setNumber(1000);
+    tickToDigit0(display);
+
+    // '1' = b,c -> pins 3,4 LOW; digit 0 = pin 10 LOW; the rest HIGH
+    CHECK_EQ(PORTD & 0xFC, 0xFC & ~0b00011000);
+    CHECK_EQ(PORTB & 0x3C, 0x3C & ~0b00000100);
+
+    // clear() shows nothing: every line at its off level
+    display.clear();
+    tickToDigit0(display);
+    CHECK_EQ(PORTD & 0xFC, 0xFC);
+    CHECK_EQ(PORTB & 0x3C, 0x3C & ~0b00000100);
+    display.end();
+    CHECK_EQ(PORTB & 0x3C, 0x3C);
+}
+
+TEST(testWiringLightsSegmentsActiveLow)
+{
+    shim::reset();
+    SevenSegment display(segmentPins, digitPins);
+    display.begin(ssfdExternalTick);
+    display.testWiring(0);
+
+    // Ends dark: segments and digits HIGH
+    CHECK_EQ(PORTD & 0xFC, 0xFC);
+    CHECK_EQ(PORTB & 0x3F, 0x3F);
+    display.end();
+}
+
+// ========== SevenSegment595 ==========
+TEST(shiftRegisterSendsInvertedBytes)
+{
+    shim::reset();
+    SevenSegment595 display(A0);
+    display.begin(ssfdExternalTick);
+    display.setNumber(1000);
+    shim::spiLogLength = 0;
+    tickToDigit0(display);
+
+    CHECK(shim::spiLogLength >= 2);
+    CHECK_EQ(shim::spiLog[shim::spiLogLength - 2], 0xFE);
+    CHECK_EQ(shim::spiLog[shim::spiLogLength - 1], 0x9F);
+    display.end();
+}
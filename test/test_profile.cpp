@@ -0,0 +1,76 @@
+/**
+ * @file test_profile.cpp
+ * @brief Minimal feature profile: numbers, hex and print() without the
+ *        font, float, blink, marquee or animation code
+ *        (built with SSFD_PROFILE_MINIMAL=1)
+ */
+
+#include "capture_display.h"
+
+typedef SevenSegmentBase::Error Error;
+
+static_assert(!SSFD_FLOAT && !SSFD_TEXT && !SSFD_BLINK && !SSFD_MARQUEE && !SSFD_ANIMATION &&
+                  !SSFD_COUNTER,
+              "test_profile expects SSFD_PROFILE_MINIMAL=1");
+
+static std::string shown(CaptureDisplay &display)
+{
+    display.scan();
+    return render(display);
+}
+
+// ========== NUMERIC SETTERS ==========
+TEST(minimalSettersRenderWithoutFont)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setNumber(1234, 1);
+    CHECK_EQ(shown(display), std::string("12.34"));
+    CHECK(display.setInt(-42) == Error::OK);
+    CHECK_EQ(shown(display), std::string("-042"));
+    CHECK(display.setFixed(-125, -1) == Error::OK);
+    CHECK_EQ(shown(display), std::string("-12.5"));
+    CHECK(display.setHex(0xC0DE) == Error::OK);
+    CHECK_EQ(shown(display), std::string("C0DE"));
+}
+
+TEST(minimalPutDigitShowsHexNumerals)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.beginFrame();
+    display.putDigit(0, 0xA);
+    display.putDigit(3, 7);
+    display.putDP(3, true);
+    display.commit();
+    CHECK_EQ(shown(display), std::string("A  7."));
+}
+
+// ========== PRINT SINK ==========
+TEST(minimalPrintKeepsNumeralsAndSign)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.print(-1.5, 1);
+    display.println();
+    CHECK_EQ(shown(display), std::string("-1.5 "));
+    display.print(0xBEEFu, HEX);
+    display.println();
+    CHECK_EQ(shown(display), std::string("BEEF"));
+
+    // Letters outside A-F have no glyph in this profile
+    display.print("Hi-9");
+    CHECK_EQ(shown(display), std::string("  -9"));
+}
+
+// ========== WIRING TEST ==========
+TEST(minimalWiringTestStillRuns)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.setNumber(7);
+    CHECK(display.startWiringTest(10) == Error::OK);
+    display.scan(SevenSegmentBase::NUM_SEGMENTS + SevenSegmentBase::NUM_DIGITS);
+    CHECK(!display.isTestingWiring());
+    CHECK_EQ(shown(display), std::string("0007"));
+}
@@ -0,0 +1,81 @@
+/**
+ * @file test_stats.cpp
+ * @brief SSFD_STATS instrumentation (linked against the SSFD_STATS=1 build)
+ */
+
+#include "capture_display.h"
+
+extern "C" void TIMER1_COMPA_vect(void);
+
+TEST(statsRecordLatencyDurationAndOverruns)
+{
+    shim::reset();
+    CaptureDisplay display;
+    display.begin();
+    display.resetStats();
+
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        TCNT1 = i % 3;                    // Latency 0..2 counts
+        TIFR1 = i == 4 ? (1 << OCF1A) : 0; // One overrun
+        TIMER1_COMPA_vect();
+    }
+
+    SevenSegmentBase::Stats st = display.getStats();
+    CHECK_EQ(st.ticks, 6u);
+    CHECK_EQ(st.minLatency, (uint16_t)0);
+    CHECK_EQ(st.maxLatency, (uint16_t)2);
+    CHECK_EQ(st.jitter, (uint16_t)2);
+    CHECK_EQ(st.missedTicks, (uint16_t)1);
+    CHECK_EQ(st.resolution, (uint16_t)1);
+    display.end();
+}
+
+TEST(resetStatsClearsWindow)
+{
+    shim::reset();
+    CaptureDisplay display;
+    display.begin();
+    TIMER1_COMPA_vect();
+    display.resetStats();
+    SevenSegmentBase::Stats st = display.getStats();
+    CHECK_EQ(st.ticks, 0u);
+    CHECK_EQ(st.minCycles, (uint16_t)0);
+    CHECK_EQ(st.maxCycles, (uint16_t)0);
+    display.end();
+}
+
+TEST(statsCountAppliedAndSkippedUpdates)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.resetStats();
+
+    display.setNumber(1);    // Applied
+    display.setNumber(1);    // Repeat call
+    display.setText("0001"); // Same glyphs
+    display.setNumber(2);    // Applied
+    display.clear();         // Applied
+    display.clear();         // Repeat call
+
+    SevenSegmentBase::Stats st = display.getStats();
+    CHECK_EQ(st.updatesApplied, 3u);
+    CHECK_EQ(st.updatesSkipped, 3u);
+}
+
+TEST(statsCountComposedFrameOnce)
+{
+    CaptureDisplay display;
+    display.beginAndSync();
+    display.resetStats();
+
+    display.beginFrame();
+    display.setNumber(21);
+    display.putChar(3, 'C');
+    display.putDP(1);
+    display.commit();
+
+    SevenSegmentBase::Stats st = display.getStats();
+    CHECK_EQ(st.updatesApplied, 1u);
+    CHECK_EQ(st.updatesSkipped, 0u);
+}
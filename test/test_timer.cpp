@@ -0,0 +1,473 @@
+/**
+ * @file test_timer.cpp
+ * @brief Timer backend register programming, refresh rate and brightness
+ */
+
+#include "capture_display.h"
+
+typedef SevenSegmentBase::Error Error;
+
+extern "C" void TIMER1_COMPA_vect(void);
+extern "C" void TIMER1_COMPB_vect(void);
+
+TEST(timer1StartsUnprescaledCtcAtDefaultRate)
+{
+    shim::reset();
+    CaptureDisplay display;
+    CHECK(display.begin() == Error::OK);
+
+    // 125 Hz x 4 digits = 500 ticks/s -> 32000 counts at 16 MHz
+    CHECK_EQ(OCR1A, (uint16_t)31999);
+    CHECK_EQ(TCCR1B, (uint8_t)((1 << WGM12) | (1 << CS10)));
+    CHECK(TIMSK1 & (1 << OCIE1A));
+
+    display.end();
+    CHECK(!(TIMSK1 & (1 << OCIE1A)));
+}
+
+TEST(timer1VectorDrivesAttachedDisplay)
+{
+    shim::reset();
+    CaptureDisplay display;
+    display.begin();
+    unsigned before = display.drives;
+    TIMER1_COMPA_vect();
+    CHECK_EQ(display.drives, before + 1);
+    display.end();
+}
+
+TEST(timer2PicksSmallestFittingPrescaler)
+{
+    shim::reset();
+    CaptureDisplay display;
+    CHECK(display.begin(ssfdTimer2) == Error::OK);
+
+    // 500 Hz on an 8-bit counter: /128, 250 counts
+    CHECK_EQ(TCCR2B, (uint8_t)5);
+    CHECK_EQ(OCR2A, (uint8_t)249);
+    display.end();
+}
+
+TEST(setRefreshRateRetunesRunningTimer)
+{
+    shim::reset();
+    CaptureDisplay display;
+    display.begin();
+    TCNT1 = 20000;
+    CHECK(display.setRefreshRate(250) == Error::OK);
+    CHECK_EQ(display.getRefreshRate(), (uint16_t)250);
+    CHECK_EQ(OCR1A, (uint16_t)15999);
+    CHECK_EQ(TCNT1, (uint16_t)0); // Past the new top: period restarted
+    display.end();
+}
+
+TEST(setRefreshRateRejectsOutOfRange)
+{
+    CaptureDisplay display;
+    CHECK(display.setRefreshRate(SevenSegmentBase::MIN_REFRESH_HZ - 1) == Error::INVALID_ARGUMENT);
+    CHECK(display.setRefreshRate(SevenSegmentBase::MAX_REFRESH_HZ + 1) == Error::INVALID_ARGUMENT);
+    CHECK_EQ(display.getRefreshRate(), SevenSegmentBase::DEFAULT_REFRESH_HZ);
+}
+
+TEST(beginMovesDisplayBetweenBackends)
+{
+    shim::reset();
+    CaptureDisplay display;
+    display.begin();
+    display.begin(ssfdTimer2);
+    CHECK(!(TIMSK1 & (1 << OCIE1A)));
+    CHECK(TIMSK2 & (1 << OCIE2A));
+    display.end();
+}
+
+// ========== POWER MANAGEMENT ==========
+// ========== BRIGHTNESS ==========
+TEST(brightnessProgramsCompareB)
+{
+    shim::reset();
+    CaptureDisplay display;
+    display.begin();
+    CHECK(!(TIMSK1 & (1 << OCIE1B))); // Full brightness: no second interrupt
+
+    CHECK(display.setBrightness(128) == Error::OK);
+    CHECK_EQ(OCR1B, (uint16_t)16000);
+    CHECK(TIMSK1 & (1 << OCIE1B));
+
+    // Compare B switches off the digit the tick lit
+    display.setNumber(8888);
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK(display.lastMask() != 0);
+    TIMER1_COMPB_vect();
+    CHECK_EQ(display.lastMask(), 0);
+
+    // The compare point follows the period
+    display.setBrightness(64);
+    display.setRefreshRate(250);
+    CHECK_EQ(OCR1B, (uint16_t)4000);
+
+    display.setBrightness(SevenSegmentBase::MAX_BRIGHTNESS);
+    CHECK(!(TIMSK1 & (1 << OCIE1B)));
+    display.end();
+}
+
+TEST(brightnessIsAppliedByBeginAndNeedsCompareB)
+{
+    shim::reset();
+    CaptureDisplay display;
+    CHECK(display.setBrightness(32) == Error::OK);
+    display.begin();
+    CHECK_EQ(OCR1B, (uint16_t)4000);
+    CHECK(TIMSK1 & (1 << OCIE1B));
+    display.end();
+    CHECK(!(TIMSK1 & (1 << OCIE1B)));
+
+    // Timer0 compare B has no second channel to blank with
+    CHECK(display.begin(ssfdTimer0B) == Error::OK);
+    CHECK_EQ(display.getBrightness(), SevenSegmentBase::MAX_BRIGHTNESS);
+    CHECK(display.setBrightness(10) == Error::NOT_SUPPORTED);
+    CHECK(display.fadeTo(10, 500) == Error::NOT_SUPPORTED);
+    display.end();
+}
+
+TEST(fadeStepsOncePerFrameInIsr)
+{
+    shim::reset();
+    CaptureDisplay display;
+    display.begin();
+    display.setBrightness(0);
+
+    // 80 ms at 125 Hz = 10 frames
+    CHECK(display.fadeTo(200, 80) == Error::OK);
+    CHECK(display.isFading());
+    for (uint8_t i = 0; i < 5 * 4; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK(display.getBrightness() >= 80 && display.getBrightness() <= 120);
+    CHECK(display.isFading());
+
+    for (uint8_t i = 0; i < 6 * 4; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK(!display.isFading());
+    CHECK_EQ(display.getBrightness(), 200);
+    CHECK_EQ(OCR1B, (uint16_t)25000);
+
+    // A set level ends a fade
+    display.fadeTo(0, 1000);
+    display.setBrightness(150);
+    CHECK(!display.isFading());
+    display.end();
+}
+
+TEST(digitBrightnessSetsEachTicksComparePoint)
+{
+    shim::reset();
+    CaptureDisplay display;
+    display.begin();
+    display.setNumber(8888);
+    CHECK(display.setDigitBrightness(1, 8) == Error::OK);
+    CHECK(display.setDigitBrightness(2, 0) == Error::OK);
+    CHECK_EQ(display.getDigitBrightness(1), 8);
+    CHECK(display.setDigitBrightness(4, 8) == Error::INVALID_ARGUMENT);
+    CHECK(display.setDigitBrightness(0, 16) == Error::INVALID_ARGUMENT);
+
+    // Frame swap tick lights digit 0, then one digit per tick
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK_EQ(display.lastMask(), 0x01);
+    CHECK(!(TIMSK1 & (1 << OCIE1B))); // Level 15 at full brightness
+
+    TIMER1_COMPA_vect();
+    CHECK_EQ(display.lastMask(), 0x02);
+    CHECK_EQ(OCR1B, (uint16_t)17000); // 8/15 of the tick, ~136/256
+    CHECK(TIMSK1 & (1 << OCIE1B));
+
+    // Level 0: the on-time is over before the tick is drawn
+    TIMER1_COMPA_vect();
+    CHECK_EQ(display.lastMask(), 0);
+
+    // Levels scale with the display brightness
+    display.setBrightness(128);
+    TIMER1_COMPA_vect();
+    TIMER1_COMPA_vect();
+    TIMER1_COMPA_vect();
+    CHECK_EQ(display.lastMask(), 0x02);
+    CHECK_EQ(OCR1B, (uint16_t)8500); // (128 * 136 + 128) >> 8 = 68
+
+    // All back at full: the display-wide duty again
+    display.setDigitBrightness(1, SevenSegmentBase::MAX_DIGIT_LEVEL);
+    display.setDigitBrightness(2, SevenSegmentBase::MAX_DIGIT_LEVEL);
+    CHECK_EQ(OCR1B, (uint16_t)16000);
+    display.setBrightness(SevenSegmentBase::MAX_BRIGHTNESS);
+    display.end();
+
+    CHECK(display.begin(ssfdTimer0B) == Error::OK);
+    CHECK(display.setDigitBrightness(0, 4) == Error::NOT_SUPPORTED);
+    display.end();
+}
+
+TEST(blankStopGatesTimerUntilNextSetter)
+{
+    shim::reset();
+    CaptureDisplay display;
+    display.begin();
+    display.setBlankStop(true);
+    display.setNumber(5);
+    for (int i = 0; i < 8; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK(TIMSK1 & (1 << OCIE1A));
+    CHECK_EQ(display.getTickRate(), 500u);
+
+    display.clear();
+    for (int i = 0; i < 4; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK(!(TIMSK1 & (1 << OCIE1A)));
+    CHECK_EQ(display.getTickRate(), 0u);
+    CHECK_EQ(display.lastMask(), (uint8_t)0);
+
+    // A stray tick while gated does nothing
+    unsigned drives = display.drives;
+    TIMER1_COMPA_vect();
+    CHECK_EQ(display.drives, drives);
+
+    display.setNumber(12);
+    CHECK(TIMSK1 & (1 << OCIE1A));
+    CHECK_EQ(display.getTickRate(), 500u);
+    display.end();
+}
+
+TEST(idleRefreshDropsRateUntilNextFrame)
+{
+    shim::reset();
+    CaptureDisplay display;
+    display.begin();
+    CHECK(display.setIdleRefresh(1, 5) == Error::INVALID_ARGUMENT);
+    CHECK(display.setIdleRefresh(1, 10) == Error::OK);
+    display.setNumber(1);
+
+    // Blinking counts as activity
+    display.startBlink(100);
+    for (int i = 0; i < 125 * 4 + 8; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK_EQ(OCR1A, (uint16_t)31999);
+    display.stopBlink();
+
+    // One second of unchanged frames at 125 Hz -> 10 Hz (40 ticks/s, /8)
+    display.setNumber(2);
+    for (int i = 0; i < 125 * 4 + 8; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK_EQ(OCR1A, (uint16_t)49999);
+    CHECK_EQ(display.getTickRate(), 40u);
+
+    display.setNumber(3);
+    CHECK_EQ(OCR1A, (uint16_t)31999);
+    CHECK_EQ(display.getTickRate(), 500u);
+    display.end();
+}
+
+// ========== Shared timer ==========
+TEST(parallelDisplaysShareOneTimer)
+{
+    shim::reset();
+    CaptureDisplay wide;
+    CaptureDisplay narrow(2);
+    CHECK(wide.begin() == Error::OK);
+    CHECK(narrow.begin() == Error::OK);
+    wide.setNumber(1234);
+    narrow.setNumber(56);
+
+    // Ticks at the widest display's digit rate: 125 Hz x 4
+    CHECK_EQ(ssfdTimer1.ticksPerFrame(), (uint8_t)4);
+    CHECK_EQ(OCR1A, (uint16_t)31999);
+    for (int i = 0; i < 4; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    wide.resetCounts();
+    narrow.resetCounts();
+    for (int i = 0; i < 4 * 10; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+
+    // Same duty for every digit: the 2-digit scan is padded with dark slots
+    for (uint8_t d = 0; d < 4; d++)
+    {
+        CHECK_EQ(wide.litTicks[d], 10u);
+    }
+    CHECK_EQ(narrow.litTicks[0], 10u);
+    CHECK_EQ(narrow.litTicks[1], 10u);
+
+    narrow.end();
+    CHECK(TIMSK1 & (1 << OCIE1A));
+    wide.end();
+    CHECK(!(TIMSK1 & (1 << OCIE1A)));
+}
+
+TEST(roundRobinLightsOneDigitAcrossDisplays)
+{
+    shim::reset();
+    ssfdTimer1.setSchedule(SSFDTimer::Schedule::ROUND_ROBIN);
+    CaptureDisplay first;
+    CaptureDisplay second(2);
+    first.begin();
+    second.begin();
+    first.setNumber(1234);
+    second.setNumber(56);
+
+    // 125 Hz x (4 + 2) digits = 750 ticks/s
+    CHECK_EQ(ssfdTimer1.ticksPerFrame(), (uint8_t)6);
+    CHECK_EQ(first.getTickRate(), 750u);
+    for (int i = 0; i < 6; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    first.resetCounts();
+    second.resetCounts();
+    unsigned overlaps = 0;
+    for (int i = 0; i < 6 * 10; i++)
+    {
+        TIMER1_COMPA_vect();
+        if (first.lastMask() != 0 && second.lastMask() != 0)
+        {
+            overlaps++;
+        }
+    }
+    CHECK_EQ(overlaps, 0u);
+    CHECK_EQ(first.litTicks[0], 10u);
+    CHECK_EQ(first.litTicks[3], 10u);
+    CHECK_EQ(second.litTicks[0], 10u);
+    CHECK_EQ(second.litTicks[1], 10u);
+
+    first.end();
+    CHECK_EQ(ssfdTimer1.ticksPerFrame(), (uint8_t)2);
+    second.end();
+    ssfdTimer1.setSchedule(SSFDTimer::Schedule::PARALLEL);
+}
+
+TEST(sharedTimerKeepsRunningForLitDisplay)
+{
+    shim::reset();
+    CaptureDisplay lit;
+    CaptureDisplay blank;
+    lit.begin();
+    blank.begin();
+    lit.setNumber(8);
+    blank.setBlankStop(true);
+    blank.clear();
+    for (int i = 0; i < 8; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK(TIMSK1 & (1 << OCIE1A));
+    CHECK_EQ(blank.lastMask(), (uint8_t)0);
+
+    // The last display to go blank stops the timer; a setter restarts it
+    lit.setBlankStop(true);
+    lit.clear();
+    for (int i = 0; i < 8; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK(!(TIMSK1 & (1 << OCIE1A)));
+    blank.setNumber(1);
+    CHECK(TIMSK1 & (1 << OCIE1A));
+    lit.end();
+    blank.end();
+}
+
+TEST(testWiringLeavesSharedTimerRunning)
+{
+    shim::reset();
+    CaptureDisplay tested;
+    CaptureDisplay other;
+    tested.begin();
+    other.begin();
+    tested.setNumber(1234);
+    other.setNumber(5678);
+    for (int i = 0; i < 8; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+
+    // Neither stopped nor restarted: the counter is not reset
+    TCNT1 = 123;
+    tested.testWiring(0);
+    CHECK(TIMSK1 & (1 << OCIE1A));
+    CHECK_EQ(TCNT1, (uint16_t)123);
+    CHECK_EQ(tested.lastMask(), (uint8_t)0);
+
+    // Both displays scan again
+    tested.resetCounts();
+    other.resetCounts();
+    for (int i = 0; i < 4; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK_EQ(tested.litTicks[0], 1u);
+    CHECK_EQ(other.litTicks[0], 1u);
+    tested.end();
+    other.end();
+}
+
+TEST(testWiringKeepsBlankGatedTimerStopped)
+{
+    shim::reset();
+    CaptureDisplay display;
+    display.begin();
+    display.setBlankStop(true);
+    display.clear();
+    for (int i = 0; i < 4; i++)
+    {
+        TIMER1_COMPA_vect();
+    }
+    CHECK(!(TIMSK1 & (1 << OCIE1A)));
+
+    display.testWiring(0);
+    CHECK(!(TIMSK1 & (1 << OCIE1A)));
+    CHECK_EQ(display.lastMask(), (uint8_t)0);
+
+    // The next setter still wakes it
+    display.setNumber(7);
+    CHECK(TIMSK1 & (1 << OCIE1A));
+    display.end();
+}
+
+TEST(refreshRateAppliesToEveryDisplayOnTimer)
+{
+    shim::reset();
+    CaptureDisplay first;
+    CaptureDisplay second;
+    first.begin();
+    second.begin();
+    CHECK(second.setRefreshRate(250) == Error::OK);
+    CHECK_EQ(first.getRefreshRate(), (uint16_t)250);
+    CHECK_EQ(OCR1A, (uint16_t)15999);
+}
+
+TEST(destroyedDisplayLeavesTimer)
+{
+    shim::reset();
+    {
+        CaptureDisplay display;
+        display.begin(ssfdExternalTick);
+        CHECK_EQ(ssfdExternalTick.ticksPerFrame(), (uint8_t)4);
+    }
+    CHECK_EQ(ssfdExternalTick.ticksPerFrame(), (uint8_t)0);
+    ssfdExternalTick.dispatch();
+}